@@ -221,9 +221,9 @@ void createObjectsFromSeed(const uint64_t seedGalaxy) {
         << seed << ")\n";
 
       cout << "    star type index = " << star.typeIndex << "\n";
-      cout << "    star type: " << star.stellarType << "\n";
-      cout << "    star designation: " << star.designation << "\n";
-      cout << "    spectral class: " << star.spectralClass << "\n";
+      cout << "    star type: " << getStellarType(star) << "\n";
+      cout << "    star designation: " << getDesignation(star) << "\n";
+      cout << "    spectral class: " << getSpectralClass(star) << "\n";
       cout << "    star luminosity [Lsol] = " << star.luminosity << "\n";
       cout << "    star temperature [K] = " << star.temperature << "\n";
       cout << "    star mass [Msol] = " << star.mass << "\n";
@@ -329,7 +329,7 @@ void createPristineObjects() {
 // demo 3: create and save galaxy seed
 //-----------------------------------
 
-void  createAndSave() {
+void  createAndSave(int format=FORMAT_JSON) {
   cout << "--- running demo 3: create and save galaxy seed\n";
 
   ProcUGalaxy galaxy;
@@ -338,8 +338,9 @@ void  createAndSave() {
   cout << "  0x" << hex << setw(16) << setfill('0') << hex << galaxy.galaxySeed 
     << dec << " ("<< galaxy.galaxySeed << ") ("<< sizeof(galaxy.galaxySeed) << " bytes)\n";
 
-  cout << "--- saving galaxy seed to galaxy.json" << "\n";
-  saveGalaxy(galaxy);
+  string galaxyFile = "galaxy." + galaxyFormatName(format);
+  cout << "--- saving galaxy seed to " << galaxyFile << "\n";
+  saveGalaxy(galaxy, galaxyFile, format);
   cout << "saved.\n";
 
   cout << "--- setting a new seed " << "\n";
@@ -347,8 +348,8 @@ void  createAndSave() {
   cout << "  0x" << hex << setw(16) << setfill('0') << hex << galaxy.galaxySeed 
     << dec << " ("<< galaxy.galaxySeed << ") ("<< sizeof(galaxy.galaxySeed) << " bytes)\n";
   
-  cout << "--- loading galaxy seed from galaxy.json" << "\n";
-  loadGalaxy(galaxy);
+  cout << "--- loading galaxy seed from " << galaxyFile << "\n";
+  loadGalaxy(galaxy, galaxyFile, nullptr, format);
   cout << "loaded.""\n";
   cout << "  0x" << hex << setw(16) << setfill('0') << hex << galaxy.galaxySeed 
     << dec << " ("<< galaxy.galaxySeed << ") ("<< sizeof(galaxy.galaxySeed) << " bytes)\n";
@@ -360,7 +361,7 @@ void  createAndSave() {
 // demo 4: save galaxy objects
 //-----------------------------------
 
-void saveGalaxyObjects() {
+void saveGalaxyObjects(int format=FORMAT_JSON) {
     cout << "--- running demo 4: create and save galaxy objects\n";
     cout << "  generating galaxy\n";
     ProcUGalaxy galaxy;
@@ -376,7 +377,7 @@ void saveGalaxyObjects() {
     // we only need one seed for this demo
     sector.systemSeeds = {systemSeeds[0]};
     sector.position = {0,0,4};
-    galaxy.sectors[seedSector] = sector;
+    galaxy.sectors[sectorKey(0,0,4)] = sector;
 
     cout << "  generating system data\n";
     // pick the n-th system
@@ -395,19 +396,9 @@ void saveGalaxyObjects() {
     }
 
     // serialize data
-    cout << "  serializing galaxy data\n";
-    json data;
-    data["galaxy"]["seed"] = galaxy.galaxySeed;
-    cout << "  serializing sector data\n";
-    data["sectors"] = galaxy.sectors;
-    cout << "  serializing system data\n";
-    json jSystem = system;
-    data["systems"]["system"] = jSystem;
-
-    // save prettified JSON to file
-    cout << "  saving galaxy data to galaxy.json\n";
-    std::ofstream outFile("galaxy.json");
-    outFile << std::setw(2) << data << std::endl;
+    string galaxyFile = "galaxy." + galaxyFormatName(format);
+    cout << "  saving galaxy data to " << galaxyFile << "\n";
+    saveGalaxy(galaxy, galaxyFile, format);
 
 } // end demo 4
 
@@ -416,7 +407,7 @@ void saveGalaxyObjects() {
 // demo 5: generate complete galaxy objects
 //-----------------------------------
 
-void generateCompleteGalaxy(uint64_t seedGalaxy=0) {
+void generateCompleteGalaxy(uint64_t seedGalaxy=0, unsigned int threads=0) {
   cout << "--- running demo 5: generating galaxy\n";
 
   ProcUGalaxy galaxy;
@@ -439,27 +430,38 @@ void generateCompleteGalaxy(uint64_t seedGalaxy=0) {
   cout << "  galaxy sectors position min/max = " << -sectorExtension << " / "
     << sectorExtension << "\n";
 
-  cout << "  generating sectors\n";
-  galaxy.genSectors();
+  if (threads>0) {
+    cout << "  generating sectors, systems, stars and planets with "
+      << threads << " thread" << (threads>1?"s":"") << "\n";
+    galaxy.genGalaxyParallel(threads);
+  } else {
+    cout << "  generating sectors\n";
+    galaxy.genSectors();
+
+    cout << "  generating systems\n";
+    for (auto& [key, sector] : galaxy.sectors) {
+      galaxy.genSystemsAt(key);
+      for (auto& systemSeed : sector.systemSeeds) {
+        galaxy.genSystem(systemSeed);
+      }
+    }
 
-  cout << "  generating systems\n";
-  for (auto& [seedSector, sector] : galaxy.sectors) {
-    galaxy.genSystems(seedSector);
-    for (auto& systemSeed : sector.systemSeeds) {
-      galaxy.genSystem(systemSeed);
+    cout << "  generating stars and planets\n";
+    for (auto& [systemSeed, system] : galaxy.systems) {
+      galaxy.genStars(systemSeed);
+      for (auto& [starSeed, star] : system.stars) {
+        galaxy.genPlanets(system.seed, star.seed);
+      }
     }
   }
   cout << "  unique system seeds = " << galaxy.systems.size() << "\n";
 
-  cout << "  generating stars and planets\n";
   int countTotalStars = 0;
   int countTotalPlanets = 0;
   int countHabitablePlanets = 0;
   for (auto& [systemSeed, system] : galaxy.systems) {
-      galaxy.genStars(systemSeed);
       for (auto& [starSeed, star] : system.stars) {
         ++countTotalStars;
-        galaxy.genPlanets(system.seed, star.seed);
         for (auto& [planetSeed, planet] : star.planets) {
           ++countTotalPlanets;
           if (getPlanetHabitability(planet)>0) {
@@ -475,6 +477,1113 @@ void generateCompleteGalaxy(uint64_t seedGalaxy=0) {
 }
 
 
+//-----------------------------------
+// demo 6: spatial system queries
+//-----------------------------------
+
+void querySystemsNearby(uint64_t seedGalaxy=0) {
+  cout << "--- running demo 6: spatial system queries\n";
+
+  ProcUGalaxy galaxy;
+  if (seedGalaxy==0) {
+    galaxy.createGalaxySeed(); // pristine seed
+  } else {
+    galaxy.setGalaxySeed(seedGalaxy); // reuse previous seed
+  }
+
+  std::vector<double> center = {0.0, 0.0, 0.0};
+  double radius = 15.0;
+  cout << "  systems within " << radius << " ly of (0,0,0)\n";
+  for (auto& result : galaxy.querySystemsInRadius(center, radius)) {
+    cout << "    0x" << setw(16) << setfill('0') << hex << result.systemSeed
+      << dec << setfill(' ') << fixed << setprecision(2)
+      << "  xyz " << setw(8) << result.position[0] << setw(8) << result.position[1]
+      << setw(8) << result.position[2] << "  distance [ly] = " << result.distance << "\n";
+  }
+
+  size_t k = 5;
+  cout << "  " << k << " nearest systems to (0,0,0)\n";
+  for (auto& result : galaxy.querySystemsNearest(center, k)) {
+    cout << "    0x" << setw(16) << setfill('0') << hex << result.systemSeed
+      << dec << setfill(' ') << "  distance [ly] = " << result.distance << "\n";
+  }
+
+  std::vector<double> boxMin = {-20.0, -5.0, -20.0};
+  std::vector<double> boxMax = {20.0, 5.0, 20.0};
+  cout << "  systems in box (-20,-5,-20)..(20,5,20) = "
+    << galaxy.querySystemsInBox(boxMin, boxMax).size() << "\n";
+
+} // end demo 6
+
+
+//-----------------------------------
+// demo 7: batch kernels
+//-----------------------------------
+
+void checkBatchKernels(uint64_t seedGalaxy=0) {
+  cout << "--- running demo 7: batch kernels\n";
+
+  ProcUGalaxy galaxy;
+  if (seedGalaxy==0) {
+    galaxy.createGalaxySeed(); // pristine seed
+  } else {
+    galaxy.setGalaxySeed(seedGalaxy); // reuse previous seed
+  }
+  galaxy.GALAXY_SIZE_LY = {400,20,400};
+
+  UniverseStore store;
+  galaxy.genStore(store, galaxy.getSectorBounds());
+  size_t count = store.starCount();
+  cout << "  kernel instruction set = " << getSimdLevel() << "\n";
+  cout << "  stars = " << count << "\n";
+
+  int repeat = 20;
+  std::vector<float> hzBatch(8*count);
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int r=0; r<repeat; ++r) {
+    habitableZoneBatch(store.starTemperature.data(), store.starLuminosity.data(),
+      hzBatch.data(), count);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  double batchMs = std::chrono::duration<double, std::milli>(end-start).count() / repeat;
+
+  std::vector<float> hzScalar(8*count);
+  start = std::chrono::high_resolution_clock::now();
+  for (int r=0; r<repeat; ++r) {
+    for (size_t i=0; i<count; ++i) {
+      float hzDistAu[8];
+      habitableZoneComplete(hzDistAu, store.starTemperature[i], store.starLuminosity[i]);
+      std::copy(hzDistAu, hzDistAu+8, hzScalar.begin()+8*i);
+    }
+  }
+  end = std::chrono::high_resolution_clock::now();
+  double scalarMs = std::chrono::duration<double, std::milli>(end-start).count() / repeat;
+
+  size_t mismatches = 0;
+  for (size_t i=0; i<8*count; ++i) {
+    mismatches += (hzBatch[i]!=hzScalar[i]) | (hzBatch[i]!=store.starHzDistAu[i]);
+  }
+  cout << fixed << setprecision(3);
+  cout << "  habitableZoneBatch : scalar " << scalarMs << " ms, batch "
+    << batchMs << " ms, mismatches = " << mismatches << "\n";
+
+  // planet physics over all planets of the store
+  size_t planets = store.planetCount();
+  cout << "  planets = " << planets << "\n";
+  std::vector<UniversePlanet> planetObjects;
+  std::vector<float> planetLuminosity;
+  for (size_t i=0; i<planets; ++i) {
+    planetObjects.push_back(store.getPlanet(i));
+    planetLuminosity.push_back(store.starLuminosity[store.planetStar[i]]);
+  }
+
+  std::vector<float> scoreScalar(planets);
+  start = std::chrono::high_resolution_clock::now();
+  for (int r=0; r<repeat; ++r) {
+    for (size_t i=0; i<planets; ++i) {
+      UniversePlanet &planet = planetObjects[i];
+      planet.temperature = planetTemperature(planetLuminosity[i], planet.starDistance);
+      scoreScalar[i] = getPlanetHabitability(planet);
+    }
+  }
+  end = std::chrono::high_resolution_clock::now();
+  scalarMs = std::chrono::duration<double, std::milli>(end-start).count() / repeat;
+
+  std::vector<float> grel, score;
+  start = std::chrono::high_resolution_clock::now();
+  for (int r=0; r<repeat; ++r) {
+    scorePlanets(store, grel, score);
+  }
+  end = std::chrono::high_resolution_clock::now();
+  batchMs = std::chrono::duration<double, std::milli>(end-start).count() / repeat;
+
+  mismatches = 0;
+  for (size_t i=0; i<planets; ++i) {
+    UniversePlanet &planet = planetObjects[i];
+    mismatches += (score[i]!=scoreScalar[i])
+      | (store.planetTemperature[i]!=planet.temperature)
+      | (store.planetProbTemp[i]!=planet.probTemp)
+      | (store.planetProbGrav[i]!=planet.probGrav)
+      | (grel[i]!=planetRelativeGravity(planet.mass, planet.radius));
+  }
+  cout << "  scorePlanets : scalar " << scalarMs << " ms, batch "
+    << batchMs << " ms, mismatches = " << mismatches << "\n";
+
+  // lockstep random streams seeded with the star seeds
+  size_t streams = count - count%8;
+  int draws = 64;
+  std::vector<uint32_t> randScalar(streams*draws);
+  start = std::chrono::high_resolution_clock::now();
+  for (int r=0; r<repeat; ++r) {
+    for (size_t i=0; i<streams; ++i) {
+      pcg32 rng(store.starSeed[i]);
+      for (int d=0; d<draws; ++d) {
+        randScalar[i*draws+d] = rng.nextUInt();
+      }
+    }
+  }
+  end = std::chrono::high_resolution_clock::now();
+  scalarMs = std::chrono::duration<double, std::milli>(end-start).count() / repeat;
+
+  std::vector<uint32_t> randLanes(streams*draws);
+  start = std::chrono::high_resolution_clock::now();
+  for (int r=0; r<repeat; ++r) {
+    for (size_t i=0; i<streams; i+=8) {
+      pcg32x8 rng(&store.starSeed[i]);
+      alignas(32) uint32_t lanes[8];
+      for (int d=0; d<draws; ++d) {
+        rng.nextUInt(lanes);
+        for (size_t l=0; l<8; ++l) {
+          randLanes[(i+l)*draws+d] = lanes[l];
+        }
+      }
+    }
+  }
+  end = std::chrono::high_resolution_clock::now();
+  batchMs = std::chrono::duration<double, std::milli>(end-start).count() / repeat;
+
+  mismatches = 0;
+  for (size_t i=0; i<streams*draws; ++i) {
+    mismatches += randLanes[i]!=randScalar[i];
+  }
+  cout << "  pcg32x8 : scalar " << scalarMs << " ms, lanes "
+    << batchMs << " ms, mismatches = " << mismatches << "\n";
+
+} // end demo 7
+
+
+//-----------------------------------
+// demo 8: fast math accuracy
+//-----------------------------------
+
+/**
+ * @brief Accuracy of an approximation against a reference.
+ * Subnormal references are counted but not rated,
+ * as they have no full relative precision.
+ */
+struct MathAccuracy {
+  size_t samples = 0;
+  size_t subnormals = 0;
+  int64_t maxUlp = 0;
+  double maxRelError = 0.0;
+
+  void add(float value, double reference) {
+    float rounded = (float)reference;
+    if (std::isnan(value) & std::isnan(rounded)) { ++samples; return; }
+    if (fabs(reference) < 1.17549435e-38) { ++samples; ++subnormals; return; }
+    int32_t a, b;
+    std::memcpy(&a, &value, sizeof(a));
+    std::memcpy(&b, &rounded, sizeof(b));
+    // map sign magnitude to a monotonic integer line
+    int64_t ia = a<0 ? (int64_t)INT32_MIN - a : a;
+    int64_t ib = b<0 ? (int64_t)INT32_MIN - b : b;
+    maxUlp = max(maxUlp, ia>ib ? ia-ib : ib-ia);
+    if (reference!=0) {
+      maxRelError = max(maxRelError, fabs((value-reference)/reference));
+    }
+    ++samples;
+  }
+
+  void print(std::string name) const {
+    cout << setfill(' ') << "  " << setw(24) << left << name << right << setw(9) << samples
+      << setw(8) << maxUlp << setw(12) << scientific << setprecision(2)
+      << maxRelError << defaultfloat << setw(10) << subnormals << "\n";
+  }
+};
+
+void checkFastMath() {
+  cout << "--- running demo 8: fast math accuracy against libm\n";
+  cout << "  kernel instruction set = " << getSimdLevel() << "\n";
+  cout << setfill(' ') << "  " << setw(24) << left << "function (range)" << right << setw(9) << "samples"
+    << setw(8) << "ulp" << setw(12) << "rel error" << setw(10) << "subnormal" << "\n";
+
+  pcg32 rng(42);
+  int samples = 1000000;
+  // log-uniform random value in [lower, upper]
+  auto logUniform = [&](float lower, float upper) {
+    return lower * (float)pow(upper/lower, rng.nextFloat());
+  };
+
+  // exponents of normalDistribution are in [-32, 0],
+  // those of inverseExpDistribution above -32 for up to 1000 au
+  MathAccuracy expDistribution, expFull;
+  for (int i=0; i<samples; ++i) {
+    float x = -32.0f * rng.nextFloat();
+    expDistribution.add(fastExp(x), exp((double)x));
+    x = -87.3f + 176.0f * rng.nextFloat();
+    expFull.add(fastExp(x), exp((double)x));
+  }
+  expDistribution.print("fastExp [-32,0]");
+  expFull.print("fastExp [-87.3,88.7]");
+
+  // star masses and planet distances
+  MathAccuracy logMass, powDistance, powMass;
+  for (int i=0; i<samples; ++i) {
+    float mass = logUniform(0.0005f, 24000.0f);
+    logMass.add(fastLog(mass), log((double)mass));
+    powMass.add(fastPow(mass, 2.3f), pow((double)mass, 2.3));
+    float distance = logUniform(0.1f, 1000.0f);
+    powDistance.add(fastPow(distance, 0.5f), sqrt((double)distance));
+  }
+  logMass.print("fastLog [5e-4,2.4e4]");
+  powMass.print("fastPow x^2.3 mass");
+  powDistance.print("fastPow x^0.5 [0.1,1e3]");
+
+  // generator functions over the star type tables
+  // beyond 7600 au the density goes through a subnormal
+  // e^-sqrt(x), rated separately
+  MathAccuracy luminosity, density, densityFar;
+  for (int idx=0; idx<24; ++idx) {
+    for (int i=0; i<samples/24; ++i) {
+      float mass = minMass[idx] + rng.nextFloat()*(maxMass[idx]-minMass[idx]);
+      float exact = calcLuminosity(mass);
+      luminosity.add(calcLuminosity(mass, true), exact);
+      float frostLimitAu = calcFrostLimit(exact);
+      float posAu = 0.1f + rng.nextFloat() * 3.0f * frostLimitAu;
+      MathAccuracy &range = posAu<7600.0f ? density : densityFar;
+      range.add(getStarMassDensity(mass, frostLimitAu, posAu, true),
+        getStarMassDensity(mass, frostLimitAu, posAu));
+    }
+  }
+  luminosity.print("calcLuminosity");
+  density.print("getStarMassDensity");
+  densityFar.print("  beyond 7600 au");
+
+  // vector kernels give the scalar results
+  std::vector<float> x(samples), y(samples), batch(samples);
+  for (int i=0; i<samples; ++i) {
+    x[i] = logUniform(1e-30f, 1e30f);
+    y[i] = -4.0f + 8.0f * rng.nextFloat();
+  }
+  size_t mismatches = 0;
+  fastLogBatch(x.data(), batch.data(), samples);
+  for (int i=0; i<samples; ++i) { mismatches += batch[i]!=fastLog(x[i]); }
+  fastExpBatch(y.data(), batch.data(), samples);
+  for (int i=0; i<samples; ++i) { mismatches += batch[i]!=fastExp(y[i]); }
+  fastPowBatch(x.data(), y.data(), batch.data(), samples);
+  for (int i=0; i<samples; ++i) { mismatches += batch[i]!=fastPow(x[i], y[i]); }
+  cout << "  batch kernel mismatches against scalar = " << mismatches << "\n";
+
+} // end demo 8
+
+
+//-----------------------------------
+// demo 9: single attributes
+//-----------------------------------
+
+void checkSingleAttributes(uint64_t seedGalaxy=0) {
+  cout << "--- running demo 9: single attributes from seeds\n";
+
+  ProcUGalaxy galaxy;
+  if (seedGalaxy==0) {
+    galaxy.createGalaxySeed(); // pristine seed
+  } else {
+    galaxy.setGalaxySeed(seedGalaxy); // reuse previous seed
+  }
+  galaxy.GALAXY_SIZE_LY = {400,20,400};
+
+  for (bool streams : {false, true}) {
+    galaxy.ATTRIBUTE_STREAMS = streams;
+    cout << "  " << (streams ? "attribute streams" : "sequential draws") << "\n";
+
+    // full generation
+    size_t systems = 0, stars = 0, mismatches = 0;
+    std::vector<uint64_t> starSeeds;
+    for (SectorCoordinate sector : galaxy.sectorRange()) {
+      for (uint64_t systemSeed : galaxy.getSystemSeeds(sector.seed)) {
+        UniverseSystem system = galaxy.genSystemData(systemSeed);
+        mismatches += system.multiplicity!=galaxy.multiplicityOf(systemSeed);
+        galaxy.genStars(system);
+        for (auto& [starSeed, star] : system.stars) {
+          mismatches += ((int)star.typeIndex!=galaxy.starTypeOf(starSeed))
+            | (star.temperature!=galaxy.starTemperatureOf(starSeed))
+            | (star.planetsCount!=galaxy.planetCountOf(starSeed));
+          starSeeds.push_back(starSeed);
+        }
+        systems++;
+      }
+    }
+    stars = starSeeds.size();
+    cout << "    systems = " << systems << ", stars = " << stars
+      << ", mismatches = " << mismatches << "\n";
+
+    // planet counts with genStar or planetCountOf
+    size_t planetsFull = 0, planetsSingle = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint64_t starSeed : starSeeds) {
+      planetsFull += galaxy.genStar(starSeed).planetsCount;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double fullMs = std::chrono::duration<double, std::milli>(end-start).count();
+    start = std::chrono::high_resolution_clock::now();
+    for (uint64_t starSeed : starSeeds) {
+      planetsSingle += galaxy.planetCountOf(starSeed);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double singleMs = std::chrono::duration<double, std::milli>(end-start).count();
+    cout << fixed << setprecision(3);
+    cout << "    planets = " << planetsSingle << " (genStar " << planetsFull
+      << "), genStar " << fullMs << " ms, planetCountOf " << singleMs << " ms\n";
+  }
+
+  // single planets from the orbit layout
+  galaxy.ATTRIBUTE_STREAMS = false;
+  size_t planets = 0, mismatches = 0;
+  double layoutMs = 0, planetsMs = 0;
+  for (SectorCoordinate sector : galaxy.sectorRange()) {
+    for (uint64_t systemSeed : galaxy.getSystemSeeds(sector.seed)) {
+      for (uint64_t starSeed : galaxy.getStarSeeds(systemSeed, galaxy.multiplicityOf(systemSeed))) {
+        UniverseStar star = galaxy.genStar(starSeed);
+        auto start = std::chrono::high_resolution_clock::now();
+        galaxy.genPlanetOrbits(star);
+        auto end = std::chrono::high_resolution_clock::now();
+        layoutMs += std::chrono::duration<double, std::milli>(end-start).count();
+        start = std::chrono::high_resolution_clock::now();
+        galaxy.genPlanets(star);
+        end = std::chrono::high_resolution_clock::now();
+        planetsMs += std::chrono::duration<double, std::milli>(end-start).count();
+        for (uint i=0; i<star.planetsCount; ++i) {
+          UniversePlanet planet = galaxy.genPlanetByIndex(star, i);
+          mismatches += json(planet).dump()!=json(star.planets[planet.seed]).dump();
+          planets++;
+        }
+      }
+    }
+  }
+  cout << "  planets by index = " << planets << ", mismatches = " << mismatches
+    << ", genPlanetOrbits " << layoutMs << " ms, genPlanets " << planetsMs << " ms\n";
+
+} // end demo 9
+
+
+//-----------------------------------
+// demo 10: seed collisions
+//-----------------------------------
+
+/**
+ * @brief Counts the seeds shared by objects of one level
+ * and by objects of different levels, for all sectors,
+ * systems, stars and planets of a galaxy.
+ * Seeds are sorted in passes over a hash partition
+ * to bound the memory.
+ */
+void scanSeedCollisions(const ProcUGalaxy &galaxy) {
+  auto start = std::chrono::high_resolution_clock::now();
+
+  // stars per system and planets per star
+  std::vector<uint8_t> multiplicity, planetCount;
+  size_t objects[4] = {0, 0, 0, 0};
+  for (SectorCoordinate sector : galaxy.sectorRange()) {
+    objects[0]++;
+    for (uint64_t systemSeed : galaxy.getSystemSeeds(sector.seed)) {
+      uint8_t stars = (uint8_t)galaxy.multiplicityOf(systemSeed);
+      multiplicity.push_back(stars);
+      objects[1]++;
+      objects[2] += stars;
+      for (uint64_t starSeed : galaxy.getStarSeeds(systemSeed, stars)) {
+        planetCount.push_back((uint8_t)galaxy.planetCountOf(starSeed));
+        objects[3] += planetCount.back();
+      }
+    }
+  }
+
+  // about 120 million seeds per pass
+  size_t total = objects[0] + objects[1] + objects[2] + objects[3];
+  uint64_t passes = total/120000000 + 1;
+  const char *levelNames[4] = {"sectors", "systems", "stars", "planets"};
+  size_t collisions[4] = {0, 0, 0, 0};
+  size_t crossLevel = 0;
+  for (uint64_t pass=0; pass<passes; ++pass) {
+    std::vector<uint64_t> seeds[4];
+    for (int level=0; level<4; ++level) {
+      seeds[level].reserve(objects[level]/passes + objects[level]/passes/50 + 1000);
+    }
+    auto keep = [&](int level, uint64_t seed) {
+      if (splitMix64(seed)%passes==pass) {
+        seeds[level].push_back(seed);
+      }
+    };
+    size_t system = 0, star = 0;
+    for (SectorCoordinate sector : galaxy.sectorRange()) {
+      keep(0, sector.seed);
+      for (uint64_t systemSeed : galaxy.getSystemSeeds(sector.seed)) {
+        keep(1, systemSeed);
+        for (uint64_t starSeed : galaxy.getStarSeeds(systemSeed, multiplicity[system++])) {
+          keep(2, starSeed);
+          for (uint64_t planetSeed : galaxy.getPlanetSeeds(starSeed, planetCount[star++])) {
+            keep(3, planetSeed);
+          }
+        }
+      }
+    }
+
+    // an object collides when an earlier object has its seed
+    for (int level=0; level<4; ++level) {
+      std::vector<uint64_t> &levelSeeds = seeds[level];
+      std::sort(levelSeeds.begin(), levelSeeds.end());
+      for (size_t i=1; i<levelSeeds.size(); ++i) {
+        collisions[level] += levelSeeds[i]==levelSeeds[i-1];
+      }
+      levelSeeds.erase(std::unique(levelSeeds.begin(), levelSeeds.end()), levelSeeds.end());
+    }
+    // merge the distinct seeds of all levels
+    size_t next[4] = {0, 0, 0, 0};
+    while (true) {
+      uint64_t smallest = UINT64_MAX;
+      int found = 0;
+      for (int level=0; level<4; ++level) {
+        if (next[level]<seeds[level].size()) {
+          smallest = std::min(smallest, seeds[level][next[level]]);
+          found++;
+        }
+      }
+      if (found==0) {
+        break;
+      }
+      int shared = 0;
+      for (int level=0; level<4; ++level) {
+        if (next[level]<seeds[level].size() && seeds[level][next[level]]==smallest) {
+          next[level]++;
+          shared++;
+        }
+      }
+      crossLevel += shared - 1;
+    }
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+  for (int level=0; level<4; ++level) {
+    cout << "    " << setfill(' ') << setw(8) << left << levelNames[level] << right << " : "
+      << setw(10) << objects[level] << " objects, "
+      << setw(10) << collisions[level] << " collisions\n";
+  }
+  cout << "    across levels : " << crossLevel << " collisions\n";
+  cout << "    scanned in " << fixed << setprecision(1)
+    << std::chrono::duration<double>(end-start).count() << " s ("
+    << passes << " passes)\n";
+} // end function
+
+void checkSeedCollisions(uint64_t seedGalaxy=0) {
+  cout << "--- running demo 10: seed collisions in a default size galaxy\n";
+
+  ProcUGalaxy galaxy;
+  if (seedGalaxy==0) {
+    galaxy.createGalaxySeed(); // pristine seed
+  } else {
+    galaxy.setGalaxySeed(seedGalaxy); // reuse previous seed
+  }
+
+  cout << "  legacy seeds\n";
+  galaxy.SEED_SCHEME = SEED_LEGACY;
+  scanSeedCollisions(galaxy);
+
+  cout << "  hashed seeds\n";
+  galaxy.SEED_SCHEME = SEED_HASHED;
+  scanSeedCollisions(galaxy);
+
+} // end demo 10
+
+
+//-----------------------------------
+// demo 11: stream region export
+//-----------------------------------
+
+bool exportRegion(uint64_t seedGalaxy, const SectorRegion &region, const string &filename) {
+  cout << "--- running demo 11: export region as NDJSON\n";
+
+  ProcUGalaxy galaxy;
+  if (seedGalaxy==0) {
+    galaxy.createGalaxySeed(); // pristine seed
+  } else {
+    galaxy.setGalaxySeed(seedGalaxy); // reuse previous seed
+  }
+  cout << "  galaxy seed = " << galaxy.galaxySeed << "\n";
+  cout << "  region = (" << region.xMin << "," << region.yMin << "," << region.zMin
+    << ")..(" << region.xMax << "," << region.yMax << "," << region.zMax << ")\n";
+
+  auto start = std::chrono::high_resolution_clock::now();
+  long count = exportRegionNdjson(galaxy, region, filename);
+  auto end = std::chrono::high_resolution_clock::now();
+  if (count<0) {
+    cout << "  export failed: could not write " << filename << "\n";
+    return false;
+  }
+  cout << "  systems written to " << filename << " = " << count << " in "
+    << fixed << setprecision(3) << std::chrono::duration<double>(end-start).count() << " s\n";
+  return true;
+
+} // end demo 11
+
+
+//-----------------------------------
+// demo 12: binary snapshot
+//-----------------------------------
+
+size_t fileSize(const string &filename) {
+  std::ifstream in(filename, std::ios::binary | std::ios::ate);
+  return (size_t)in.tellg();
+}
+
+void checkSnapshot(uint64_t seedGalaxy=0) {
+  cout << "--- running demo 12: binary columnar snapshot\n";
+
+  ProcUGalaxy galaxy;
+  if (seedGalaxy==0) {
+    galaxy.createGalaxySeed(); // pristine seed
+  } else {
+    galaxy.setGalaxySeed(seedGalaxy); // reuse previous seed
+  }
+  galaxy.GALAXY_SIZE_LY = {400,20,400};
+
+  UniverseStore store;
+  galaxy.genStore(store, galaxy.getSectorBounds());
+  cout << "  systems = " << store.systemCount() << ", stars = " << store.starCount()
+    << ", planets = " << store.planetCount() << "\n";
+  cout << fixed << setprecision(3) << setfill(' ');
+
+  // json lines of the same objects
+  auto start = std::chrono::high_resolution_clock::now();
+  {
+    std::ofstream out("galaxy.ndjson");
+    for (size_t i=0; i<store.systemCount(); ++i) {
+      out << json(store.getSystem(i)).dump() << '\n';
+    }
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  cout << "  json   : save " << std::chrono::duration<double, std::milli>(end-start).count()
+    << " ms, " << fileSize("galaxy.ndjson") << " bytes (partial fields)\n";
+
+  start = std::chrono::high_resolution_clock::now();
+  bool saved = saveSnapshot(galaxy, store, "galaxy.snapshot");
+  end = std::chrono::high_resolution_clock::now();
+  cout << "  binary : save " << std::chrono::duration<double, std::milli>(end-start).count()
+    << " ms, " << fileSize("galaxy.snapshot") << " bytes, saved = " << saved << "\n";
+
+  UniverseStore loaded;
+  uint64_t loadedSeed = 0;
+  start = std::chrono::high_resolution_clock::now();
+  bool valid = loadSnapshot(loaded, "galaxy.snapshot", &loadedSeed);
+  end = std::chrono::high_resolution_clock::now();
+  cout << "  binary : load " << std::chrono::duration<double, std::milli>(end-start).count()
+    << " ms, valid = " << valid << "\n";
+
+  // round trip: positions within half a quantization step,
+  // everything else identical when saved again
+  double positionError = 0.0;
+  for (size_t i=0; i<store.systemCount(); ++i) {
+    positionError = max(positionError, fabs(loaded.systemX[i]-store.systemX[i]));
+    positionError = max(positionError, fabs(loaded.systemY[i]-store.systemY[i]));
+    positionError = max(positionError, fabs(loaded.systemZ[i]-store.systemZ[i]));
+  }
+  saveSnapshot(loaded, "galaxy.snapshot.copy", loadedSeed, galaxy.SECTOR_SIZE_LY);
+  std::ifstream original("galaxy.snapshot", std::ios::binary);
+  std::ifstream copy("galaxy.snapshot.copy", std::ios::binary);
+  bool identical = std::equal(std::istreambuf_iterator<char>(original), std::istreambuf_iterator<char>(),
+    std::istreambuf_iterator<char>(copy), std::istreambuf_iterator<char>());
+  std::remove("galaxy.snapshot.copy");
+  cout << "  round trip : seed " << (loadedSeed==galaxy.galaxySeed ? "ok" : "differs")
+    << ", columns " << (identical ? "identical" : "differ")
+    << ", max position error [ly] = " << scientific << positionError << fixed << "\n";
+
+  // analytics on two columns only
+  std::vector<uint8_t> starType, planetHz;
+  std::vector<uint32_t> planetStar;
+  start = std::chrono::high_resolution_clock::now();
+  readSnapshotColumn("galaxy.snapshot", "starTypeIndex", starType);
+  readSnapshotColumn("galaxy.snapshot", "planetIsInHz", planetHz);
+  readSnapshotColumn("galaxy.snapshot", "planetStar", planetStar);
+  std::vector<size_t> hzPlanets(24, 0);
+  for (size_t p=0; p<planetHz.size(); ++p) {
+    hzPlanets[starType[planetStar[p]]] += planetHz[p];
+  }
+  end = std::chrono::high_resolution_clock::now();
+  cout << "  habitable zone planets by star type (3 columns read in "
+    << std::chrono::duration<double, std::milli>(end-start).count() << " ms)\n";
+  for (size_t t=0; t<hzPlanets.size(); ++t) {
+    if (hzPlanets[t]>0) {
+      cout << "    " << setw(2) << t << " " << setw(2) << spectralClass[t]
+        << setw(4) << luminosityClass[t] << " : " << hzPlanets[t] << "\n";
+    }
+  }
+
+} // end demo 12
+
+
+//-----------------------------------
+// demo 13: memory mapped catalog
+//-----------------------------------
+
+void checkCatalog(uint64_t seedGalaxy=0) {
+  cout << "--- running demo 13: memory mapped catalog\n";
+
+  ProcUGalaxy galaxy;
+  if (seedGalaxy==0) {
+    galaxy.createGalaxySeed(); // pristine seed
+  } else {
+    galaxy.setGalaxySeed(seedGalaxy); // reuse previous seed
+  }
+  galaxy.GALAXY_SIZE_LY = {400,20,400};
+  cout << fixed << setprecision(3) << setfill(' ');
+
+  auto start = std::chrono::high_resolution_clock::now();
+  bool baked = bakeCatalog(galaxy, galaxy.getSectorBounds(), "galaxy.catalog");
+  auto end = std::chrono::high_resolution_clock::now();
+  cout << "  bake : " << std::chrono::duration<double, std::milli>(end-start).count()
+    << " ms, " << fileSize("galaxy.catalog") << " bytes, baked = " << baked << "\n";
+
+  ProcUCatalog catalog;
+  start = std::chrono::high_resolution_clock::now();
+  bool opened = catalog.open("galaxy.catalog");
+  end = std::chrono::high_resolution_clock::now();
+  cout << "  open : " << std::chrono::duration<double, std::micro>(end-start).count()
+    << " us, opened = " << opened << ", systems = " << catalog.systemCount() << "\n";
+  if (!opened) {
+    return;
+  }
+
+  // lookup every system by seed and by sector
+  std::vector<uint64_t> systemSeeds;
+  size_t sectorMismatches = 0;
+  for (SectorCoordinate sector : galaxy.sectorRange()) {
+    std::vector<uint64_t> seeds = galaxy.getSystemSeeds(sector.seed);
+    auto [first, count] = catalog.findSector(sectorKey(sector.x, sector.y, sector.z));
+    sectorMismatches += count!=seeds.size();
+    for (size_t i=0; i<count && i<seeds.size(); ++i) {
+      sectorMismatches += catalog.getSystemView(first+i).seed!=seeds[i];
+    }
+    systemSeeds.insert(systemSeeds.end(), seeds.begin(), seeds.end());
+  }
+  start = std::chrono::high_resolution_clock::now();
+  size_t found = 0;
+  for (uint64_t seed : systemSeeds) {
+    found += catalog.findSystem(seed)!=ProcUCatalog::npos;
+  }
+  end = std::chrono::high_resolution_clock::now();
+  cout << "  seed lookups : " << found << " of " << systemSeeds.size() << " found, "
+    << std::chrono::duration<double, std::nano>(end-start).count() / systemSeeds.size()
+    << " ns per lookup, sector mismatches = " << sectorMismatches << "\n";
+
+  // materialized systems against generated systems
+  size_t mismatches = 0;
+  start = std::chrono::high_resolution_clock::now();
+  for (uint64_t seed : systemSeeds) {
+    UniverseSystem stored;
+    catalog.findSystem(seed, stored);
+    UniverseSystem generated = galaxy.genSystemComplete(seed);
+    mismatches += (stored.seed!=generated.seed) | (stored.position!=generated.position)
+      | (stored.multiplicity!=generated.multiplicity) | (stored.stars.size()!=generated.stars.size());
+    for (auto& [starSeed, star] : generated.stars) {
+      UniverseStar &other = stored.stars[starSeed];
+      mismatches += (other.mass!=star.mass) | (other.temperature!=star.temperature)
+        | (other.planets.size()!=star.planets.size());
+      for (auto& [planetSeed, planet] : star.planets) {
+        UniversePlanet &otherPlanet = other.planets[planetSeed];
+        mismatches += (otherPlanet.mass!=planet.mass) | (otherPlanet.radius!=planet.radius)
+          | (otherPlanet.atmosphere.pressure!=planet.atmosphere.pressure)
+          | (otherPlanet.atmosphere.composition.elements!=planet.atmosphere.composition.elements);
+      }
+    }
+  }
+  end = std::chrono::high_resolution_clock::now();
+  cout << "  materialized against generated systems : mismatches = " << mismatches
+    << " (" << std::chrono::duration<double, std::milli>(end-start).count() << " ms)\n";
+
+} // end demo 13
+
+
+//-----------------------------------
+// demo 14: streaming galaxy loader
+//-----------------------------------
+
+/**
+ * @brief counts systems of a loaded galaxy that differ
+ * from the generated galaxy, compared as serialized json
+ * without the parent sector (set by the region export only)
+ */
+size_t countMismatches(const ProcUGalaxy &loaded, const ProcUGalaxy &galaxy) {
+  size_t mismatches = 0;
+  for (auto& [systemSeed, system] : loaded.systems) {
+    auto found = galaxy.systems.find(systemSeed);
+    if (found==galaxy.systems.end()) { mismatches++; continue; }
+    json a = system, b = found->second;
+    a.erase("sector");
+    b.erase("sector");
+    mismatches += a.dump()!=b.dump();
+  }
+  return mismatches;
+}
+
+void checkGalaxyLoader(uint64_t seedGalaxy=0, int format=FORMAT_JSON) {
+  cout << "--- running demo 14: save and stream load a complete galaxy\n";
+
+  ProcUGalaxy galaxy;
+  if (seedGalaxy==0) {
+    galaxy.createGalaxySeed(); // pristine seed
+  } else {
+    galaxy.setGalaxySeed(seedGalaxy); // reuse previous seed
+  }
+  galaxy.GALAXY_SIZE_LY = {400,20,400};
+  galaxy.genGalaxyParallel(1);
+  cout << fixed << setprecision(3) << setfill(' ');
+  cout << "  sectors = " << galaxy.sectors.size() << ", systems = " << galaxy.systems.size() << "\n";
+
+  string galaxyFile = "galaxy." + galaxyFormatName(format);
+  auto start = std::chrono::high_resolution_clock::now();
+  bool saved = saveGalaxy(galaxy, galaxyFile, format);
+  auto end = std::chrono::high_resolution_clock::now();
+  cout << "  save        : " << std::chrono::duration<double, std::milli>(end-start).count()
+    << " ms, " << fileSize(galaxyFile) << " bytes, saved = " << saved << "\n";
+
+  // complete restore
+  ProcUGalaxy loaded;
+  start = std::chrono::high_resolution_clock::now();
+  bool valid = loadGalaxy(loaded, galaxyFile, nullptr, format);
+  end = std::chrono::high_resolution_clock::now();
+  cout << "  load        : " << std::chrono::duration<double, std::milli>(end-start).count()
+    << " ms, valid = " << valid << ", sectors = " << loaded.sectors.size()
+    << ", systems = " << loaded.systems.size() << "\n";
+  size_t sectorMismatches = 0;
+  for (auto& [key, sector] : galaxy.sectors) {
+    auto found = loaded.sectors.find(key);
+    if (found==loaded.sectors.end() || json(sector).dump()!=json(found->second).dump()) {
+      sectorMismatches++;
+    }
+  }
+  cout << "  mismatches  : sectors = " << sectorMismatches
+    << ", systems = " << countMismatches(loaded, galaxy)
+    << ", seed = " << (loaded.galaxySeed!=galaxy.galaxySeed) << "\n";
+
+  // filtered restore: eastern half of the galaxy
+  auto east = [](const UniverseSector &sector) { return sector.position[0]>=0; };
+  size_t expected = 0;
+  for (auto& [key, sector] : galaxy.sectors) {
+    if (east(sector)) { expected += sector.systemSeeds.size(); }
+  }
+  ProcUGalaxy filtered;
+  start = std::chrono::high_resolution_clock::now();
+  valid = loadGalaxy(filtered, galaxyFile, east, format);
+  end = std::chrono::high_resolution_clock::now();
+  cout << "  load x>=0   : " << std::chrono::duration<double, std::milli>(end-start).count()
+    << " ms, valid = " << valid << ", systems = " << filtered.systems.size()
+    << " (expected " << expected << "), mismatches = " << countMismatches(filtered, galaxy) << "\n";
+
+  // NDJSON region export read back with the same loader
+  SectorRegion region = galaxy.getSectorBounds();
+  exportRegionNdjson(galaxy, region, "galaxy.ndjson");
+  ProcUGalaxy lines;
+  lines.setGalaxySeed(galaxy.galaxySeed);
+  start = std::chrono::high_resolution_clock::now();
+  long count = loadRegionNdjson(lines, "galaxy.ndjson", east);
+  end = std::chrono::high_resolution_clock::now();
+  cout << "  ndjson x>=0 : " << std::chrono::duration<double, std::milli>(end-start).count()
+    << " ms, systems = " << count << " (expected " << expected << "), mismatches = "
+    << countMismatches(lines, galaxy) << "\n";
+
+} // end demo 14
+
+
+//-----------------------------------
+// demo 15: galaxy file formats
+//-----------------------------------
+
+void compareFormats(uint64_t seedGalaxy=0) {
+  cout << "--- running demo 15: compare json, cbor, msgpack and bson\n";
+
+  ProcUGalaxy galaxy;
+  if (seedGalaxy==0) {
+    galaxy.createGalaxySeed(); // pristine seed
+  } else {
+    galaxy.setGalaxySeed(seedGalaxy); // reuse previous seed
+  }
+  // demo 5 galaxy, central region
+  galaxy.GALAXY_SIZE_LY = {400,10,400};
+  galaxy.genGalaxyParallel(1);
+  cout << fixed << setprecision(3) << setfill(' ');
+  cout << "  sectors = " << galaxy.sectors.size() << ", systems = " << galaxy.systems.size() << "\n";
+
+  auto seconds = [](auto start, auto end) { return std::chrono::duration<double>(end-start).count(); };
+  cout << "  galaxy file : format       bytes   save MB/s   load MB/s  mismatches\n";
+  for (int format : {FORMAT_JSON, FORMAT_CBOR, FORMAT_MSGPACK, FORMAT_BSON}) {
+    string galaxyFile = "galaxy." + galaxyFormatName(format);
+    auto start = std::chrono::high_resolution_clock::now();
+    bool saved = saveGalaxy(galaxy, galaxyFile, format);
+    auto end = std::chrono::high_resolution_clock::now();
+    double saveTime = seconds(start, end);
+    double megabytes = fileSize(galaxyFile)/1.0e6;
+
+    ProcUGalaxy loaded;
+    start = std::chrono::high_resolution_clock::now();
+    bool valid = saved && loadGalaxy(loaded, galaxyFile, nullptr, format);
+    end = std::chrono::high_resolution_clock::now();
+    double loadTime = seconds(start, end);
+    size_t mismatches = galaxy.systems.size()-loaded.systems.size() + countMismatches(loaded, galaxy);
+    std::remove(galaxyFile.c_str());
+
+    cout << "              " << setw(7) << galaxyFormatName(format) << setw(12) << (size_t)(megabytes*1.0e6)
+      << setw(12) << megabytes/saveTime << setw(12) << megabytes/loadTime
+      << setw(12) << mismatches << (valid ? "" : "  (not loaded)") << "\n";
+  }
+
+  // single systems through encodeObject and decodeObject
+  cout << "  systems     : format       bytes encode MB/s decode MB/s  mismatches\n";
+  for (int format : {FORMAT_JSON, FORMAT_CBOR, FORMAT_MSGPACK, FORMAT_BSON}) {
+    vector<vector<uint8_t>> encoded;
+    encoded.reserve(galaxy.systems.size());
+    size_t bytes = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (auto& [systemSeed, system] : galaxy.systems) {
+      encoded.push_back(encodeObject(system, format));
+      bytes += encoded.back().size();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double encodeTime = seconds(start, end);
+
+    ProcUGalaxy decoded;
+    start = std::chrono::high_resolution_clock::now();
+    for (auto& data : encoded) {
+      UniverseSystem system = decodeObject<UniverseSystem>(data, format);
+      decoded.systems[system.seed] = system;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double decodeTime = seconds(start, end);
+
+    cout << "              " << setw(7) << galaxyFormatName(format) << setw(12) << bytes
+      << setw(12) << bytes/1.0e6/encodeTime << setw(12) << bytes/1.0e6/decodeTime
+      << setw(12) << countMismatches(decoded, galaxy) << "\n";
+  }
+
+} // end demo 15
+
+
+//-----------------------------------
+// demo 16: system summaries
+//-----------------------------------
+
+void checkSystemSummaries(uint64_t seedGalaxy=0) {
+  cout << "--- running demo 16: system summaries against full generation\n";
+
+  ProcUGalaxy galaxy;
+  if (seedGalaxy==0) {
+    galaxy.createGalaxySeed(); // pristine seed
+  } else {
+    galaxy.setGalaxySeed(seedGalaxy); // reuse previous seed
+  }
+  galaxy.GALAXY_SIZE_LY = {400,20,400};
+  cout << fixed << setprecision(3) << setfill(' ');
+
+  for (bool streams : {false, true}) {
+    galaxy.ATTRIBUTE_STREAMS = streams;
+    cout << "  " << (streams ? "attribute streams" : "sequential draws") << "\n";
+
+    // map level fields from the full system and star generation
+    size_t systems = 0, mismatches = 0;
+    for (SectorCoordinate sector : galaxy.sectorRange()) {
+      for (uint64_t systemSeed : galaxy.getSystemSeeds(sector.seed)) {
+        UniverseSystem system = galaxy.genSystemData(systemSeed);
+        galaxy.genStars(system);
+        SystemSummary summary = galaxy.genSystemSummary(systemSeed);
+        const UniverseStar *dominant = nullptr;
+        for (uint64_t starSeed : galaxy.getStarSeeds(systemSeed, system.multiplicity)) {
+          const UniverseStar &star = system.stars[starSeed];
+          if (!dominant || star.mass>dominant->mass) { dominant = &star; }
+        }
+        bool equal = summary.multiplicity==system.multiplicity
+          && summary.typeIndex==dominant->typeIndex
+          && summary.temperature==dominant->temperature
+          && summary.temperatureSubclass==dominant->temperatureSubclass
+          && std::equal(summary.color, summary.color+3, dominant->color.begin());
+        for (int i=0; i<3; ++i) {
+          equal = equal && summary.position[i]==(float)system.position[i];
+        }
+        mismatches += !equal;
+        systems++;
+      }
+    }
+    cout << "    systems = " << systems << ", mismatches = " << mismatches << "\n";
+
+    // timing: zoomed out map of all sectors
+    size_t count = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (SectorCoordinate sector : galaxy.sectorRange()) {
+      for (uint64_t systemSeed : galaxy.getSystemSeeds(sector.seed)) {
+        UniverseSystem system = galaxy.genSystemData(systemSeed);
+        galaxy.genStars(system);
+        count += system.stars.size();
+      }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double fullMs = std::chrono::duration<double, std::milli>(end-start).count();
+    start = std::chrono::high_resolution_clock::now();
+    for (SectorCoordinate sector : galaxy.sectorRange()) {
+      count += galaxy.genSystemSummaries(sector.seed).size();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double summaryMs = std::chrono::duration<double, std::milli>(end-start).count();
+    cout << "    genSystemData + genStars " << fullMs << " ms, genSystemSummaries "
+      << summaryMs << " ms (" << sizeof(SystemSummary) << " bytes per system)\n";
+  }
+
+} // end demo 16
+
+
+//-----------------------------------
+// demo 17: staged galaxy search
+//-----------------------------------
+
+void stagedSearch(uint64_t seedGalaxy=0) {
+  cout << "--- running demo 17: staged galaxy search\n";
+
+  ProcUGalaxy galaxy;
+  if (seedGalaxy==0) {
+    galaxy.createGalaxySeed(); // pristine seed
+  } else {
+    galaxy.setGalaxySeed(seedGalaxy); // reuse previous seed
+  }
+  cout << fixed << setprecision(3) << setfill(' ');
+
+  // G-type main-sequence stars with a warm terran planet
+  // that has an atmosphere, within 200 ly
+  GalaxyQuery query;
+  query.centerLy = {0.0, 0.0, 0.0};
+  query.radiusLy = 200.0;
+  query.star = [](const UniverseStar &star) {
+    return string(getSpectralClass(star))=="G" && string(getLuminosityClass(star))=="V";
+  };
+  query.planet = [](const UniversePlanet &planet) {
+    return getPeriodicType(planet.typeIndex)=="Warm Terran";
+  };
+  query.atmosphere = [](const UniversePlanet &planet) {
+    return planet.atmosphere.radius>0;
+  };
+  cout << "  G V stars with a warm terran planet with atmosphere within "
+    << query.radiusLy << " ly\n";
+
+  GalaxyQueryStats stats;
+  auto start = std::chrono::high_resolution_clock::now();
+  std::vector<SystemQueryMatch> matches = galaxy.querySystems(query, &stats);
+  auto end = std::chrono::high_resolution_clock::now();
+  double stagedMs = std::chrono::duration<double, std::milli>(end-start).count();
+
+  // pruned counts whole subtrees, the atmosphere level
+  // counts atmosphere draws (one per planet)
+  const char *levels[QUERY_LEVELS] = {"system", "star", "planet", "atmo draw"};
+  cout << "  level        generated    rejected      pruned     matched\n";
+  for (int level=0; level<QUERY_LEVELS; ++level) {
+    cout << "  " << left << setw(10) << levels[level] << right
+      << setw(12) << stats.generated[level] << setw(12) << stats.rejected[level]
+      << setw(12) << stats.pruned[level] << setw(12) << stats.matched[level] << "\n";
+  }
+
+  // the same search generating everything and filtering at the end
+  size_t systems = 0, stars = 0, planets = 0;
+  start = std::chrono::high_resolution_clock::now();
+  for (const SystemQueryResult &result : galaxy.querySystemsInRadius(query.centerLy, query.radiusLy)) {
+    UniverseSystem system = galaxy.genSystemComplete(result.systemSeed);
+    size_t starsBefore = stars;
+    for (auto& [starSeed, star] : system.stars) {
+      if (!query.star(star)) { continue; }
+      size_t matching = 0;
+      for (auto& [planetSeed, planet] : star.planets) {
+        matching += query.planet(planet) && query.atmosphere(planet);
+      }
+      stars += matching>0;
+      planets += matching;
+    }
+    systems += stars>starsBefore;
+  }
+  end = std::chrono::high_resolution_clock::now();
+  double filterMs = std::chrono::duration<double, std::milli>(end-start).count();
+
+  cout << "  staged query " << stagedMs << " ms, generate and filter " << filterMs << " ms\n";
+  cout << "  matches: systems = " << matches.size() << " (filter " << systems
+    << "), stars = " << stats.matched[QUERY_STAR] << " (filter " << stars
+    << "), planets = " << stats.matched[QUERY_PLANET] << " (filter " << planets << ")\n";
+  for (size_t i=0; i<matches.size() && i<5; ++i) {
+    const SystemQueryMatch &match = matches[i];
+    cout << "    system " << match.location.systemSeed << " at " << match.location.distance << " ly:";
+    for (auto& [starSeed, star] : match.system.stars) {
+      cout << " " << getStellarType(star) << " with " << star.planets.size() << " planet"
+        << (star.planets.size()==1 ? "" : "s");
+    }
+    cout << "\n";
+  }
+
+} // end demo 17
+
+
+//-----------------------------------
+// demo 18: system cache
+//-----------------------------------
+
+void checkSystemCache(uint64_t seedGalaxy=0, unsigned int threads=0) {
+  cout << "--- running demo 18: memory bounded system cache\n";
+
+  ProcUGalaxy galaxy;
+  if (seedGalaxy==0) {
+    galaxy.createGalaxySeed(); // pristine seed
+  } else {
+    galaxy.setGalaxySeed(seedGalaxy); // reuse previous seed
+  }
+  galaxy.GALAXY_SIZE_LY = {200,20,200};
+  vector<uint64_t> systemSeeds;
+  for (SectorCoordinate sector : galaxy.sectorRange()) {
+    for (uint64_t systemSeed : galaxy.getSystemSeeds(sector.seed)) {
+      systemSeeds.push_back(systemSeed);
+    }
+  }
+  auto printStats = [](const char *label, const CacheStats &stats) {
+    cout << "  " << label << ": hits = " << stats.hits << ", misses = " << stats.misses
+      << ", evictions = " << stats.evictions << ", entries = " << stats.entries
+      << ", bytes = " << stats.bytes << "\n";
+  };
+
+  // a budget of 100 times the first system
+  const size_t budget = 100 * getSystemMemorySize(galaxy.genSystemComplete(systemSeeds[0]));
+  ProcUSystemCache cache(galaxy, budget);
+  cout << "  systems = " << systemSeeds.size() << ", budget = " << budget << " bytes\n";
+
+  // one pass, every system against full generation
+  size_t overBudget = 0, mismatches = 0;
+  for (uint64_t systemSeed : systemSeeds) {
+    auto system = cache.getSystem(systemSeed);
+    CacheStats stats = cache.getStats();
+    overBudget += stats.bytes>budget && stats.entries>1;
+    mismatches += json(*system).dump()!=json(galaxy.genSystemComplete(systemSeed)).dump();
+  }
+  CacheStats stats = cache.getStats();
+  printStats("pass    ", stats);
+  cout << "    over budget = " << overBudget << ", mismatches = " << mismatches << "\n";
+
+  // least recently used order: the last system is kept, the first evicted
+  cache.getSystem(systemSeeds.back());
+  bool lastHit = cache.getStats().hits==stats.hits+1;
+  cache.getSystem(systemSeeds.front());
+  bool firstMiss = cache.getStats().misses==stats.misses+1;
+  cout << "    last system hit = " << lastHit << ", first system miss = " << firstMiss << "\n";
+
+  // concurrent lookups of a working set within the budget
+  if (threads==0) { threads = 4; }
+  cache.clear();
+  CacheStats before = cache.getStats();
+  const size_t lookups = 20000;
+  std::vector<std::thread> workers;
+  for (unsigned int t=0; t<threads; ++t) {
+    workers.emplace_back([&, t]() {
+      std::mt19937 rng(t);
+      for (size_t i=0; i<lookups; ++i) {
+        cache.getSystem(systemSeeds[rng() % 50]);
+      }
+    });
+  }
+  for (auto &worker : workers) { worker.join(); }
+  stats = cache.getStats();
+  printStats("threads ", stats);
+  cout << "    lookups = " << (stats.hits+stats.misses) - (before.hits+before.misses)
+    << " (expected " << threads*lookups << "), within budget = " << (stats.bytes<=budget) << "\n";
+
+} // end demo 18
+
+
 //===================================
 // main program
 //===================================
@@ -482,6 +1591,12 @@ void generateCompleteGalaxy(uint64_t seedGalaxy=0) {
 int main(int argc, char **argv) {
   uint16_t iDemo = 1; // demo number to run without parameter
   uint64_t uSeed = 0; // seed number to use
+  unsigned int iThreads = 0; // generator threads (0 = serial)
+  string filename = "galaxy.ndjson"; // export file (demo 11)
+  SectorRegion region; // export region (demo 11)
+  int format = FORMAT_JSON; // galaxy file format (demos 3, 4, 14)
+  region.xMin = -5; region.yMin = -1; region.zMin = -5;
+  region.xMax = 5; region.yMax = 1; region.zMax = 5;
 
   cout << "--- gengalaxy | v0.00.28 | 2020-03-22 ---\n";
 
@@ -495,12 +1610,31 @@ int main(int argc, char **argv) {
       cout << "--- usage:\n";
       cout << "  -h --help         : show this help\n";
       cout << "  -s --seed uint    : generate with defined seed\n";
+      cout << "  -t --threads uint : generate with threads (demos 5, 18)\n";
+      cout << "  -r --region int x6: sector region xMin yMin zMin xMax yMax zMax\n";
+      cout << "                      (maximum exclusive) to export (demo 11)\n";
+      cout << "  -f --file path    : export file (demo 11)\n";
+      cout << "  -F --format name  : galaxy file format json, cbor, msgpack\n";
+      cout << "                      or bson (demos 3, 4, 14)\n";
       cout << "  -d --demo uint    : run defined demo\n";
       cout << "          --demo 1  : (default) create seeds example\n";
       cout << "          --demo 2  : create objects example\n";
-      cout << "          --demo 3  : save galaxy seed in json format\n";
-      cout << "          --demo 4  : save objects in json format\n";
+      cout << "          --demo 3  : save galaxy seed (json or -F format)\n";
+      cout << "          --demo 4  : save objects (json or -F format)\n";
       cout << "          --demo 5  : generate whole galaxy and count objects\n";
+      cout << "          --demo 6  : query systems near a position\n";
+      cout << "          --demo 7  : check batch kernels against scalar functions\n";
+      cout << "          --demo 8  : check fast math accuracy against libm\n";
+      cout << "          --demo 9  : check single attributes against generation\n";
+      cout << "          --demo 10 : scan galaxy seeds for collisions (minutes)\n";
+      cout << "          --demo 11 : stream region systems to NDJSON file\n";
+      cout << "          --demo 12 : save and load a binary columnar snapshot\n";
+      cout << "          --demo 13 : bake and query a memory mapped catalog\n";
+      cout << "          --demo 14 : save and stream load a complete galaxy\n";
+      cout << "          --demo 15 : compare galaxy file formats\n";
+      cout << "          --demo 16 : check system summaries against generation\n";
+      cout << "          --demo 17 : staged galaxy search with pruning counters\n";
+      cout << "          --demo 18 : check the system cache budget and counters\n";
       return 0;
     } else
     if (args[i] == "-s" or args[i] == "--seed") {
@@ -513,10 +1647,30 @@ int main(int argc, char **argv) {
       cout << "param demo = 0x" << hex << setw(4) << setfill('0') << iDemo
         << dec << " (" << iDemo << ") ("<< sizeof(iDemo) << " bytes)\n";
     }
+    if (args[i] == "-t" or args[i] == "--threads") {
+      iThreads = (unsigned int)stoi(args[i+1]);
+      cout << "param threads = " << iThreads << "\n";
+    }
     if (args[i] == "-f" or args[i] == "--file") {
-      string filename = args[i+1];
+      filename = args[i+1];
       cout << "filename: " + filename +  "\n";
     }
+    if (args[i] == "-F" or args[i] == "--format") {
+      format = galaxyFormat(args[i+1]);
+      if (format<0) {
+        cout << "unknown format: " + args[i+1] + "\n";
+        return 1;
+      }
+      cout << "format: " + galaxyFormatName(format) + "\n";
+    }
+    if (args[i] == "-r" or args[i] == "--region") {
+      region.xMin = stoi(args[i+1]);
+      region.yMin = stoi(args[i+2]);
+      region.zMin = stoi(args[i+3]);
+      region.xMax = stoi(args[i+4]);
+      region.yMax = stoi(args[i+5]);
+      region.zMax = stoi(args[i+6]);
+    }
   }
 
 
@@ -544,23 +1698,75 @@ int main(int argc, char **argv) {
     if (uSeed>0) {
       cout << "this demo always creates a pristine seed\n";
     }
-    createAndSave();
+    createAndSave(format);
   } // demo 3
 
   if (iDemo==4) {
     if (uSeed>0) {
       cout << "this demo always creates a pristine seed\n";
     }
-    saveGalaxyObjects();
+    saveGalaxyObjects(format);
   } // demo 4
 
   if (iDemo==5) {
     if (uSeed>0) {
-      generateCompleteGalaxy(uSeed);
+      generateCompleteGalaxy(uSeed, iThreads);
     } else {
-      generateCompleteGalaxy();
+      generateCompleteGalaxy(0, iThreads);
     }
   } // demo 4
 
+  if (iDemo==6) {
+    querySystemsNearby(uSeed);
+  } // demo 6
+
+  if (iDemo==7) {
+    checkBatchKernels(uSeed);
+  } // demo 7
+
+  if (iDemo==8) {
+    checkFastMath();
+  } // demo 8
+
+  if (iDemo==9) {
+    checkSingleAttributes(uSeed);
+  } // demo 9
+
+  if (iDemo==10) {
+    checkSeedCollisions(uSeed);
+  } // demo 10
+
+  if (iDemo==11) {
+    if (!exportRegion(uSeed, region, filename)) { return 1; }
+  } // demo 11
+
+  if (iDemo==12) {
+    checkSnapshot(uSeed);
+  } // demo 12
+
+  if (iDemo==13) {
+    checkCatalog(uSeed);
+  } // demo 13
+
+  if (iDemo==14) {
+    checkGalaxyLoader(uSeed, format);
+  } // demo 14
+
+  if (iDemo==15) {
+    compareFormats(uSeed);
+  } // demo 15
+
+  if (iDemo==16) {
+    checkSystemSummaries(uSeed);
+  } // demo 16
+
+  if (iDemo==17) {
+    stagedSearch(uSeed);
+  } // demo 17
+
+  if (iDemo==18) {
+    checkSystemCache(uSeed, iThreads);
+  } // demo 18
+
   return 0;
 } // end main
@@ -1,6 +1,6 @@
 //===================================
 // @file   : libprocu-galaxy.hpp
-// @version: 2020-05-21
+// @version: 2026-10-16
 // @created: 2020-02-01
 // @author : pyramid
 // @brief  : library for procedural galaxy generation
@@ -45,6 +45,22 @@
  *     default: 10 ly across in all directions x,y,z
  * - MAX_SYSTEMS : maximum number of systems in a sector
  *    default: 10 with uniform distribution
+ * - THREADS : generator threads for genGalaxyParallel
+ *    default: 0 (all hardware threads)
+ * - STAR_COLOR_TABLE : star colors interpolated from a
+ *   temperature lookup table (StarColorTable), with at most
+ *   1 deviation per channel from the analytic fit
+ *    default: false
+ * - FAST_MATH : star luminosity and planet mass density with
+ *   the approximate math functions (fastExp, fastLog, fastPow)
+ *    default: false
+ * - ATTRIBUTE_STREAMS : one random stream per system and
+ *   star attribute (changes the generated galaxy)
+ *    default: false
+ * - SEED_SCHEME : seed derivation, SEED_LEGACY offsets or
+ *   SEED_HASHED (hashSeed, no overlapping seeds; changes
+ *   the generated galaxy)
+ *    default: SEED_LEGACY
  * 
  * **Generating Galaxy Pipeline**
  * - first create a galaxy seed (or reuse the one you have)
@@ -56,12 +72,26 @@
  * (in case lengthy data is not (yet) required), and
  * generating data content for any object.
  * 
+ * **Concurrent Generation**
+ * All const generator functions neither read nor modify the
+ * galaxy data (sectors, systems, rng) and return populated
+ * objects, so that several threads may use the same galaxy:
+ * - genSystemData, genSystemComplete
+ * - genStar, genStarComplete
+ * - genStars(system), genPlanets(star)
+ * - genPlanet(..., rng) with a caller owned generator
+ * - genPlanetOrbits(star), genPlanet(orbit, star),
+ *   genPlanetByIndex(star, index)
+ * 
  * **Creating Seeds (Functions)**
  * - createGalaxySeed
  * - getSectorSeed
+ * - sectorRange (lazy sector coordinates and seeds,
+ *   for the whole galaxy or a SectorRegion)
  * - getSystemSeeds
  * - getStarSeeds
  * - getPlanetSeeds
+ * - hashSeed (child seeds with SEED_SCHEME = SEED_HASHED)
  * 
  * **Generating Universe Data**
  * Galaxy data is generated in the ProcUUniverse class
@@ -70,7 +100,52 @@
  * constructor and destructor.
  * - genSystem
  * - genStars, genStar
- * - genPlanets, genPlanet
+ * - genPlanets, genPlanet (genPlanetBody without atmosphere)
+ *   in two passes: genPlanetOrbits lays out distances and
+ *   accretion limits, then each planet is generated from
+ *   its own seed and orbit, independent of its siblings
+ * - genGalaxyParallel (whole galaxy on several threads)
+ * 
+ * **Single Attributes**
+ * multiplicityOf, starTypeOf, starTemperatureOf and planetCountOf
+ * return one attribute from the object seed without generating
+ * the object. Sequential draws are skipped with pcg32::advance;
+ * with ATTRIBUTE_STREAMS each attribute has its own stream.
+ * genSystemSummary returns the map level fields of a system
+ * (position, multiplicity, dominant star type and color) as
+ * a 32 byte SystemSummary without generating its stars.
+ * 
+ * **Columnar Store**
+ * UniverseStore keeps systems, stars and planets in
+ * per-field arrays with parent index ranges for batch passes.
+ * UniverseSystemView, UniverseStarView and UniversePlanetView
+ * read the store in place. Fill it with genStore or append.
+ * 
+ * **Caching Systems**
+ * ProcUSystemCache keeps complete systems within a memory
+ * budget and regenerates evicted systems from their seed.
+ * 
+ * **Batch Kernels**
+ * Batch functions take arrays of inputs (e.g. UniverseStore
+ * columns) and give the same results as their scalar
+ * counterparts, using AVX2 or SSE2 when compiled for it
+ * (see getSimdLevel, PROCU_NO_SIMD).
+ * - habitableZoneBatch
+ * - planetHabitabilityBatch (scorePlanets for a UniverseStore)
+ * - fastExpBatch, fastLogBatch, fastPowBatch
+ * - pcg32x4, pcg32x8 (lockstep pcg32 streams)
+ * 
+ * **Spatial Queries**
+ * Queries visit only the sectors overlapping the query volume
+ * and take systems from the galaxy model or generate their
+ * position from the system seed.
+ * - querySystemsInBox
+ * - querySystemsInRadius
+ * - querySystemsNearest
+ * - querySystems (GalaxyQuery with predicates per system,
+ *   star, planet and atmosphere, evaluated while generating
+ *   so that rejected subtrees are not generated;
+ *   GalaxyQueryStats counts the pruned objects per level)
  * 
  * The **object hierarchy** is as follows:
  * - galaxy
@@ -83,12 +158,15 @@
  * ----- orbitals
  * 
  * Generated data hierarchy is stored as maps of
- * - sectors in galaxy
+ * - sectors in galaxy (SectorTable keyed by the Z-order
+ *   sectorKey, reversed by sectorCoordinate)
  * - systems in galaxy
  * - stars in system
  * - planets in system
  * - atmosphere in planet
- * - element composition in atmosphere
+ * Element composition in atmosphere is stored in fixed
+ * slots per gas (AtmosphereGas), names are only used
+ * when listing or serializing.
  * 
  * There is no link between the sector and system data.
  * However for fast retrieval, sectors will hold the system
@@ -106,8 +184,23 @@
  * - Libraries available in popular programming languages
  * 
  * Serialization functions
- * - saveGalaxy
- * - loadGalaxy
+ * - saveGalaxy (configuration, sectors and systems)
+ * - loadGalaxy (SAX streamed, optional sector filter)
+ * - encodeObject, decodeObject (single objects)
+ * Galaxies and objects are encoded as text JSON or in the
+ * binary CBOR, MessagePack or BSON formats (GALAXY_FORMAT).
+ * - exportRegionNdjson (one generated system per line,
+ *   streamed without holding the region in memory)
+ * - loadRegionNdjson (reads the export back)
+ * 
+ * For analytics a UniverseStore is saved as a binary
+ * columnar snapshot (SnapshotHeader, SnapshotColumn):
+ * - saveSnapshot, loadSnapshot
+ * - readSnapshotColumn (a single column, e.g. starTypeIndex)
+ * 
+ * Baked catalogs (bakeCatalog) add seed and sector key
+ * indices to a snapshot; ProcUCatalog maps them read-only
+ * and looks up systems without parsing the file.
  * 
  * **References**
  * For the creation of hierarchically dependent seeds
@@ -146,6 +239,8 @@
 #include <iostream>
 // standard string
 #include <string>
+// float bit patterns (memcpy)
+#include <cstring>
 // display formatting (setw)
 #include <iomanip>
 // for holding seeds, colors
@@ -161,6 +256,55 @@
 #include <chrono>
 // file in/output
 #include <fstream>
+// parallel generation
+#include <thread>
+#include <atomic>
+// sorting work lists
+#include <algorithm>
+// snapshot offset columns (partial_sum)
+#include <numeric>
+// system cache
+#include <unordered_map>
+#include <unordered_set>
+// loader filter callbacks
+#include <functional>
+#include <memory>
+#include <mutex>
+
+
+//-----------------------------------
+// includes: SIMD intrinsics
+//-----------------------------------
+
+// batch kernels use AVX2 or SSE2 when the compiler targets them
+// (e.g. -mavx2), otherwise a scalar loop.
+// Define PROCU_NO_SIMD to always use the scalar loop.
+#ifndef PROCU_NO_SIMD
+  #if defined(__AVX2__)
+    #define PROCU_SIMD_AVX2
+  #endif
+  #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+    #define PROCU_SIMD_SSE2
+  #endif
+#endif
+#if defined(PROCU_SIMD_AVX2) || defined(PROCU_SIMD_SSE2)
+  #include <immintrin.h>
+#endif
+
+
+//-----------------------------------
+// includes: memory mapped files
+//-----------------------------------
+
+// ProcUCatalog maps catalog files where POSIX mmap is
+// available, otherwise it reads them into memory.
+#if defined(__unix__) || defined(__APPLE__)
+  #define PROCU_MMAP
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
 
 
 //-----------------------------------
@@ -258,6 +402,12 @@ float Lsol = 3.84e26f;          // Sun luminosity in W
 //blackbody constant 5.67E-008 [W*m^-2*K^-4]
 float Lsigma = 5.67e-8f;
 
+// planet surface temperature model (see planetTemperature),
+// shared by planetTemperature and planetHabitabilityBatch
+float planetAabs_Arad = 0.25f;  // absorbing by radiating area
+float planetAlbedo = 0.0f;      // Earth = 0.29f
+float planetEta = 1.0f;         // emissivity, Earth = 0.96f
+
 // time constants
 // Earth year in [s] = 365.25636 d * 24 h * 60 min * 60 s
 float yearEarth = 31558149.5f;  // Earth year in seconds
@@ -270,14 +420,255 @@ float bar2Pa = 1e5f;            // 1 bar = 100 000 Pascal
 // libProcU procu::MathUtil
 //-----------------------------------
 
+//---------------------------------
+// approximate math functions
+//---------------------------------
+
+/**
+ * Fast float approximations of exp, log and pow, with
+ * polynomial kernels after Cephes (S. Moshier).
+ * The four lane versions (fastExp4, fastLog4, fastPow4) use
+ * the same operations per lane and give the same results
+ * as the scalar functions.
+ * Measured against libm in double precision for every
+ * float input:
+ * - fastExp: max 1 ulp (rel. error < 8.2e-8), including the
+ *   subnormal results below -87.3, inf above 88.72.
+ * - fastLog: max 1 ulp for x > 0 outside [0.97..1.03],
+ *   abs. error < 1e-9 inside, log(0) = -inf, log(x<0) = NaN.
+ * - fastPow: exp(y*log(x)) for x > 0, relative error
+ *   about (2 + |y*log(x)|) ulp, from rounding y*log(x).
+ * See demo 8 of gengalaxy for the generator input ranges.
+ */
+
+// bit pattern of a float
+inline uint32_t floatBits(float x) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+// float from a bit pattern
+inline float bitsFloat(uint32_t bits) {
+    float x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+/**
+ * @brief Fast exponential function e^x.
+ * See approximate math functions for the error bounds.
+ */
+float fastExp(float x) {
+    if (x != x) { return x; }
+    x = min(max(x, -104.0f), 89.0f);
+    // x = n*ln(2) + r, |r| <= ln(2)/2
+    float fx = x * 1.44269504088896341f + 0.5f;
+    float n = (float)(int)fx;
+    n -= (n > fx) ? 1.0f : 0.0f;
+    x = x - n * 0.693359375f;
+    x = x - n * -2.12194440e-4f;
+    float z = x * x;
+    float y = 1.9875691500e-4f;
+    y = y * x + 1.3981999507e-3f;
+    y = y * x + 8.3334519073e-3f;
+    y = y * x + 4.1665795894e-2f;
+    y = y * x + 1.6666665459e-1f;
+    y = y * x + 5.0000001201e-1f;
+    y = y * z + x;
+    y = y + 1.0f;
+    // 2^n in two factors to reach the subnormal and overflow range
+    int ni = (int)n;
+    int half = ni / 2;
+    y = y * bitsFloat((uint32_t)(half + 127) << 23);
+    y = y * bitsFloat((uint32_t)(ni - half + 127) << 23);
+    return y;
+}
+
+/**
+ * @brief Fast natural logarithm ln(x).
+ * See approximate math functions for the error bounds.
+ */
+float fastLog(float x) {
+    if (!(x > 0.0f) | (x == INFINITY)) {
+        return (x == 0.0f) ? -INFINITY : ((x < 0.0f) ? NAN : x);
+    }
+    // scale subnormal numbers into the normal range
+    float scale = 0.0f;
+    if (x < 1.17549435e-38f) {
+        x *= 8388608.0f; // 2^23
+        scale = -23.0f;
+    }
+    uint32_t bits = floatBits(x);
+    // mantissa in [0.5, 1) and exponent
+    float e = (float)((int)(bits >> 23) - 126) + scale;
+    float m = bitsFloat((bits & 0x807fffffu) | 0x3f000000u);
+    if (m < 0.707106781186547524f) {
+        e -= 1.0f;
+        x = m + m - 1.0f;
+    } else {
+        x = m - 1.0f;
+    }
+    float z = x * x;
+    float y = 7.0376836292e-2f;
+    y = y * x - 1.1514610310e-1f;
+    y = y * x + 1.1676998740e-1f;
+    y = y * x - 1.2420140846e-1f;
+    y = y * x + 1.4249322787e-1f;
+    y = y * x - 1.6668057665e-1f;
+    y = y * x + 2.0000714765e-1f;
+    y = y * x - 2.4999993993e-1f;
+    y = y * x + 3.3333331174e-1f;
+    y = y * x * z;
+    y = y + e * -2.12194440e-4f;
+    y = y + -0.5f * z;
+    x = x + y;
+    x = x + e * 0.693359375f;
+    return x;
+}
+
+/**
+ * @brief Fast power function x^y for x > 0.
+ * See approximate math functions for the error bounds.
+ */
+float fastPow(float x, float y) {
+    return fastExp(y * fastLog(x));
+}
+
+#if defined(PROCU_SIMD_SSE2)
+/**
+ * @brief Four lane fastExp.
+ */
+inline __m128 fastExp4(__m128 x) {
+    __m128 nan = _mm_cmpunord_ps(x, x);
+    __m128 input = x;
+    x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-104.0f)), _mm_set1_ps(89.0f));
+    __m128 fx = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(1.44269504088896341f)), _mm_set1_ps(0.5f));
+    __m128i ni = _mm_cvttps_epi32(fx);
+    __m128 n = _mm_cvtepi32_ps(ni);
+    __m128 floorFix = _mm_cmpgt_ps(n, fx);
+    n = _mm_sub_ps(n, _mm_and_ps(floorFix, _mm_set1_ps(1.0f)));
+    ni = _mm_add_epi32(ni, _mm_castps_si128(floorFix)); // -1 where rounded up
+    x = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(0.693359375f)));
+    x = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(-2.12194440e-4f)));
+    __m128 z = _mm_mul_ps(x, x);
+    __m128 y = _mm_set1_ps(1.9875691500e-4f);
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.3981999507e-3f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(8.3334519073e-3f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(4.1665795894e-2f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.6666665459e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(5.0000001201e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, z), x);
+    y = _mm_add_ps(y, _mm_set1_ps(1.0f));
+    // 2^n in two factors, half rounded towards zero
+    __m128i half = _mm_srai_epi32(_mm_add_epi32(ni, _mm_srli_epi32(ni, 31)), 1);
+    __m128i bias = _mm_set1_epi32(127);
+    y = _mm_mul_ps(y, _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(half, bias), 23)));
+    y = _mm_mul_ps(y, _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_sub_epi32(ni, half), bias), 23)));
+    return _mm_or_ps(_mm_and_ps(nan, input), _mm_andnot_ps(nan, y));
+}
+
+/**
+ * @brief Four lane fastLog.
+ */
+inline __m128 fastLog4(__m128 x) {
+    __m128 input = x;
+    // scale subnormal numbers into the normal range
+    __m128 subnormal = _mm_cmplt_ps(x, _mm_set1_ps(1.17549435e-38f));
+    x = _mm_or_ps(_mm_and_ps(subnormal, _mm_mul_ps(x, _mm_set1_ps(8388608.0f))),
+        _mm_andnot_ps(subnormal, x));
+    __m128 scale = _mm_and_ps(subnormal, _mm_set1_ps(-23.0f));
+    __m128i bits = _mm_castps_si128(x);
+    __m128 e = _mm_add_ps(_mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126))), scale);
+    __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x807fffff)),
+        _mm_set1_epi32(0x3f000000)));
+    __m128 low = _mm_cmplt_ps(m, _mm_set1_ps(0.707106781186547524f));
+    e = _mm_sub_ps(e, _mm_and_ps(low, _mm_set1_ps(1.0f)));
+    x = _mm_sub_ps(_mm_add_ps(m, _mm_and_ps(low, m)), _mm_set1_ps(1.0f));
+    __m128 z = _mm_mul_ps(x, x);
+    __m128 y = _mm_set1_ps(7.0376836292e-2f);
+    y = _mm_sub_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.1514610310e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.1676998740e-1f));
+    y = _mm_sub_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.2420140846e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.4249322787e-1f));
+    y = _mm_sub_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.6668057665e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(2.0000714765e-1f));
+    y = _mm_sub_ps(_mm_mul_ps(y, x), _mm_set1_ps(2.4999993993e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(3.3333331174e-1f));
+    y = _mm_mul_ps(_mm_mul_ps(y, x), z);
+    y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(-2.12194440e-4f)));
+    y = _mm_add_ps(y, _mm_mul_ps(_mm_set1_ps(-0.5f), z));
+    x = _mm_add_ps(x, y);
+    x = _mm_add_ps(x, _mm_mul_ps(e, _mm_set1_ps(0.693359375f)));
+    // special values: 0 -> -inf, negative or NaN -> NaN, inf -> inf
+    __m128 zero = _mm_setzero_ps();
+    __m128 special = _mm_or_ps(_mm_cmpnlt_ps(zero, input), _mm_cmpeq_ps(input, _mm_set1_ps(INFINITY)));
+    __m128 value = _mm_or_ps(_mm_and_ps(_mm_cmpeq_ps(input, zero), _mm_set1_ps(-INFINITY)),
+        _mm_and_ps(_mm_cmpneq_ps(input, zero), _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(input, zero), _mm_set1_ps(NAN)),
+        _mm_andnot_ps(_mm_cmplt_ps(input, zero), input))));
+    return _mm_or_ps(_mm_and_ps(special, value), _mm_andnot_ps(special, x));
+}
+
+/**
+ * @brief Four lane fastPow for x > 0.
+ */
+inline __m128 fastPow4(__m128 x, __m128 y) {
+    return fastExp4(_mm_mul_ps(y, fastLog4(x)));
+}
+#endif
+
+/**
+ * @brief e^x for count values, see fastExp.
+ */
+void fastExpBatch(const float *x, float *result, size_t count) {
+    size_t i = 0;
+#if defined(PROCU_SIMD_SSE2)
+    for (; i+4 <= count; i += 4) {
+        _mm_storeu_ps(result+i, fastExp4(_mm_loadu_ps(x+i)));
+    }
+#endif
+    for (; i < count; ++i) { result[i] = fastExp(x[i]); }
+}
+
+/**
+ * @brief ln(x) for count values, see fastLog.
+ */
+void fastLogBatch(const float *x, float *result, size_t count) {
+    size_t i = 0;
+#if defined(PROCU_SIMD_SSE2)
+    for (; i+4 <= count; i += 4) {
+        _mm_storeu_ps(result+i, fastLog4(_mm_loadu_ps(x+i)));
+    }
+#endif
+    for (; i < count; ++i) { result[i] = fastLog(x[i]); }
+}
+
+/**
+ * @brief x^y for count values, see fastPow.
+ */
+void fastPowBatch(const float *x, const float *y, float *result, size_t count) {
+    size_t i = 0;
+#if defined(PROCU_SIMD_SSE2)
+    for (; i+4 <= count; i += 4) {
+        _mm_storeu_ps(result+i, fastPow4(_mm_loadu_ps(x+i), _mm_loadu_ps(y+i)));
+    }
+#endif
+    for (; i < count; ++i) { result[i] = fastPow(x[i], y[i]); }
+}
+
 /**
  * @brief Returns normal distribution value at point x, with
  * @param x - point to get distribution at
  * @param mu - median point, expected: frostLimit/2
  * @param sigma - standard deviation, expected: frostLimit/16
+ * @param fastMath - use fastExp instead of pow and exp
  * @return
  */
-float normalDistribution(float x, float mu, float sigma) {
+float normalDistribution(float x, float mu, float sigma, bool fastMath=false) {
+    if (fastMath) {
+        float d = x-mu;
+        return (1 / ( sigma * sqrt(2 * M_PI) )) * fastExp( - (d*d) / (2 * (sigma*sigma)) );
+    }
     return (1 / ( sigma * sqrt(2 * M_PI) )) * exp( - pow(x-mu,2) /  (2 * pow(sigma,2)) );
 }
 
@@ -285,12 +676,30 @@ float normalDistribution(float x, float mu, float sigma) {
   * @brief Returns inverse exponential distribution value at point x, with
   * @param x - point to get distribution at
   * @param skew - skewness of the function, expected: 0.5
+  * @param fastMath - use fastExp and fastPow instead of exp and pow
   * @return
   */
-float inverseExpDistribution(float x, float skew) {
+float inverseExpDistribution(float x, float skew, bool fastMath=false) {
+    if (fastMath) {
+        return fastExp(-fastPow(x, skew));
+    }
     return exp(-pow(x, skew));
 }
 
+/**
+  * @brief Returns the instruction set used by the batch kernels,
+  * "avx2", "sse2" or "scalar".
+  */
+const char* getSimdLevel() {
+#if defined(PROCU_SIMD_AVX2)
+    return "avx2";
+#elif defined(PROCU_SIMD_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
 
 //---------------------------------
 // random distribution functions
@@ -300,9 +709,9 @@ float inverseExpDistribution(float x, float skew) {
   * Random index from non-linear
   * cumulative distribution function
   */
-int getRndCdfIdx(float rn, std::list<float> cdf) {
+int getRndCdfIdx(float rn, const std::list<float> &cdf) {
   int idx = 0;
-  for(std::list<float>::iterator iter=cdf.begin(); iter != cdf.end(); ++iter ) {
+  for(std::list<float>::const_iterator iter=cdf.begin(); iter != cdf.end(); ++iter ) {
     float ub = *iter; // upper bound
     idx = std::distance(cdf.begin(), iter);
     //cout << idx << " ";
@@ -313,6 +722,249 @@ int getRndCdfIdx(float rn, std::list<float> cdf) {
   return idx;
 }
 
+/**
+  * Random index from non-linear
+  * cumulative distribution function array
+  */
+template <size_t N>
+int getRndCdfIdx(float rn, const float (&cdf)[N]) {
+  int idx = 0;
+  for (size_t i=0; i<N; ++i) {
+    idx = (int)i;
+    if (rn<=cdf[i]) { break; }
+  }
+  return idx;
+}
+
+/**
+  * @brief Constant time sampler for a cumulative distribution
+  * function, built at compile time.
+  * Returns exactly the index getRndCdfIdx returns (the first
+  * index with rn <= cdf[idx], or the last index), so that
+  * existing seeds keep generating the same objects.
+  * It uses a guide table (Chen and Asau indexed search):
+  * bucket b holds the first index with cdf >= b/BUCKETS,
+  * which is where the search for any rn in that bucket starts.
+  * With more buckets than cdf entries, the search
+  * takes about one step.
+  * BUCKETS is a power of two so that rn*BUCKETS is exact.
+  */
+template <size_t N, size_t BUCKETS=64>
+struct CdfSampler {
+
+  float cdf[N];
+  uint8_t guide[BUCKETS];
+
+  constexpr CdfSampler(const float (&table)[N]) : cdf(), guide() {
+    for (size_t i=0; i<N; ++i) {
+      cdf[i] = table[i];
+    }
+    size_t idx = 0;
+    for (size_t b=0; b<BUCKETS; ++b) {
+      float lowerBound = (float)b / (float)BUCKETS;
+      while ((idx<N-1) && (cdf[idx]<lowerBound)) { ++idx; }
+      guide[b] = (uint8_t)idx;
+    }
+  }
+
+  constexpr int sample(float rn) const {
+    int bucket = (int)(rn * (float)BUCKETS);
+    if (bucket<0) { bucket = 0; }
+    if (bucket>=(int)BUCKETS) { bucket = BUCKETS-1; }
+    int idx = guide[bucket];
+    while ((idx<(int)N-1) && (rn>cdf[idx])) { ++idx; }
+    return idx;
+  }
+
+}; // end struct CdfSampler
+
+
+//---------------------------------
+// seed hashing
+//---------------------------------
+
+/**
+  * @brief SplitMix64 finalizer, a bijective 64 bit mixing
+  * function: distinct inputs give distinct outputs.
+  */
+uint64_t splitMix64(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+} // end function
+
+/**
+  * @brief Counter based child seed: the index-th object
+  * of a hierarchy level below a parent object.
+  * Children of one parent and level never share a seed,
+  * since both mixing steps are bijective; other pairs
+  * collide with probability 2^-64.
+  * @param parentSeed - seed of the parent object
+  * @param level - hierarchy level of the child
+  * @param index - counter of the child within the parent
+  */
+uint64_t hashSeed(uint64_t parentSeed, uint64_t level, uint64_t index) {
+    const uint64_t golden = 0x9e3779b97f4a7c15ull;
+    uint64_t key = splitMix64(parentSeed + level * golden);
+    return splitMix64(key + (index + 1) * golden);
+} // end function
+
+
+//---------------------------------
+// vectorized random generator
+//---------------------------------
+
+/**
+  * @brief Advances four pcg32 streams by one step and
+  * returns their outputs, exactly as pcg32::nextUInt per stream.
+  * With AVX2 the 64 bit state multiply is built from 32 bit
+  * products; without it four independent scalar steps are
+  * faster than the SSE2 emulation of that multiply.
+  * @param state - four stream states, updated
+  * @param inc - four stream increments
+  * @param result - four outputs
+  */
+inline void pcg32Next4(uint64_t *state, const uint64_t *inc, uint32_t *result) {
+#if defined(PROCU_SIMD_AVX2)
+    __m256i old = _mm256_loadu_si256((const __m256i*)state);
+    // state = old * PCG32_MULT + inc (mod 2^64)
+    __m256i mult = _mm256_set1_epi64x((long long)PCG32_MULT);
+    __m256i cross = _mm256_add_epi64(
+        _mm256_mul_epu32(_mm256_srli_epi64(old, 32), mult),
+        _mm256_mul_epu32(old, _mm256_srli_epi64(mult, 32)));
+    __m256i next = _mm256_add_epi64(_mm256_mul_epu32(old, mult), _mm256_slli_epi64(cross, 32));
+    next = _mm256_add_epi64(next, _mm256_loadu_si256((const __m256i*)inc));
+    _mm256_storeu_si256((__m256i*)state, next);
+    // output permutation: xorshift high bits, random rotation
+    __m256i low32 = _mm256_set1_epi64x(0xffffffffll);
+    __m256i xorshifted = _mm256_and_si256(_mm256_srli_epi64(
+        _mm256_xor_si256(_mm256_srli_epi64(old, 18), old), 27), low32);
+    __m256i rot = _mm256_srli_epi64(old, 59);
+    __m256i rotated = _mm256_or_si256(_mm256_srlv_epi64(xorshifted, rot),
+        _mm256_and_si256(_mm256_sllv_epi64(xorshifted,
+        _mm256_sub_epi64(_mm256_set1_epi64x(32), rot)), low32));
+    // gather the low 32 bits of the four 64 bit lanes
+    __m256i packed = _mm256_permutevar8x32_epi32(rotated, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+    _mm_storeu_si128((__m128i*)result, _mm256_castsi256_si128(packed));
+#else
+    for (int l = 0; l < 4; l++) {
+        uint64_t old = state[l];
+        state[l] = old * PCG32_MULT + inc[l];
+        uint32_t xorshifted = (uint32_t) (((old >> 18u) ^ old) >> 27u);
+        uint32_t rot = (uint32_t) (old >> 59u);
+        result[l] = (xorshifted >> rot) | (xorshifted << ((~rot + 1u) & 31));
+    }
+#endif
+}
+
+/**
+  * @brief Several pcg32 streams advanced in lockstep.
+  * Lane l returns exactly the sequence of the scalar
+  * pcg32(seeds[l], initseq), so existing seeds stay valid.
+  * Groups of four lanes are advanced with AVX2
+  * when available (see pcg32Next4).
+  * Use pcg32x4 or pcg32x8.
+  */
+template <size_t LANES>
+struct pcg32Lanes {
+
+  static_assert(LANES%4==0, "pcg32Lanes needs a multiple of four lanes");
+
+  alignas(32) uint64_t state[LANES];
+  alignas(32) uint64_t inc[LANES];
+
+  // all lanes with the default pcg32 state
+  pcg32Lanes() {
+    for (size_t l=0; l<LANES; ++l) {
+      pcg32 rng;
+      state[l] = rng.state;
+      inc[l] = rng.inc;
+    }
+  }
+
+  pcg32Lanes(const uint64_t *seeds, uint64_t initseq = 1u) {
+    seed(seeds, initseq);
+  }
+
+  /**
+   * @brief Seeds lane l as pcg32(seeds[l], initseq).
+   */
+  void seed(const uint64_t *seeds, uint64_t initseq = 1u) {
+    for (size_t l=0; l<LANES; ++l) {
+      setLane(l, pcg32(seeds[l], initseq));
+    }
+  }
+
+  // scalar generator at the position of a lane
+  pcg32 lane(size_t l) const {
+    pcg32 rng;
+    rng.state = state[l];
+    rng.inc = inc[l];
+    return rng;
+  }
+
+  // continue a lane from a scalar generator
+  void setLane(size_t l, const pcg32 &rng) {
+    state[l] = rng.state;
+    inc[l] = rng.inc;
+  }
+
+  /**
+   * @brief Uniformly distributed unsigned 32-bit numbers,
+   * one per lane.
+   */
+  void nextUInt(uint32_t *result) {
+    for (size_t l=0; l<LANES; l+=4) {
+      pcg32Next4(state+l, inc+l, result+l);
+    }
+  }
+
+  /**
+   * @brief Uniformly distributed numbers 0 <= r < bound,
+   * one per lane. Lanes draw again on their own stream
+   * when rejected, as pcg32::nextUInt(bound).
+   */
+  void nextUInt(uint32_t bound, uint32_t *result) {
+    for (size_t l=0; l<LANES; ++l) {
+      pcg32 rng = lane(l);
+      result[l] = rng.nextUInt(bound);
+      setLane(l, rng);
+    }
+  }
+
+  /**
+   * @brief Floats on the interval [0, 1), one per lane,
+   * as pcg32::nextFloat.
+   */
+  void nextFloat(float *result) {
+    alignas(32) uint32_t bits[LANES];
+    nextUInt(bits);
+    for (size_t l=0; l<LANES; ++l) {
+      bits[l] = (bits[l] >> 9) | 0x3f800000u;
+      float x;
+      std::memcpy(&x, &bits[l], sizeof(x));
+      result[l] = x - 1.0f;
+    }
+  }
+
+  /**
+   * @brief Advances all lanes by delta steps.
+   */
+  void advance(int64_t delta) {
+    for (size_t l=0; l<LANES; ++l) {
+      pcg32 rng = lane(l);
+      rng.advance(delta);
+      setLane(l, rng);
+    }
+  }
+
+}; // end struct pcg32Lanes
+
+// four lockstep pcg32 streams
+using pcg32x4 = pcg32Lanes<4>;
+// eight lockstep pcg32 streams
+using pcg32x8 = pcg32Lanes<8>;
+
 
 //-----------------------------------
 // Model of Universe Atmosphere
@@ -322,52 +974,79 @@ int getRndCdfIdx(float rn, std::list<float> cdf) {
 // atmosphere enumerators
 //-----------------------------------
 
+/**
+ * @brief Atmosphere gases, indexing the fixed
+ * composition slots and gas tables.
+ * More frequent elements on top.
+ */
+enum AtmosphereGas {
+  GAS_CO2 = 0,
+  GAS_H2,
+  GAS_N2,
+  GAS_O2,
+  GAS_He,
+  GAS_Ar,
+  GAS_CH4,
+  GAS_Ne,
+  GAS_Kr,
+  GAS_Xe,
+  GAS_COUNT
+};
+
+// gas names in AtmosphereGas order
 // more frequent elements on top
-std::string componentOrder[10] = {
+std::string componentOrder[GAS_COUNT] = {
   "CO2", "H2", "N2", "O2", "He",
   "Ar", "CH4", "Ne", "Kr", "Xe"
 };
 
+// gases in alphabetical name order
+// used when listing compositions
+constexpr int componentNameOrder[GAS_COUNT] = {
+  GAS_Ar, GAS_CH4, GAS_CO2, GAS_H2, GAS_He,
+  GAS_Kr, GAS_N2, GAS_Ne, GAS_O2, GAS_Xe
+};
+
 // atmosphere element composition probability
-std::map<std::string, float> elementProb = {
-    {"CO2", 0.965f},  // run 0
-    {"H2",  0.963f},
-    {"N2",  0.780f},  // run 2
-    {"O2",  0.210f},
-    {"He",  0.102f},  // run 4
-    {"Ar",  0.016f},
-    {"CH4", 0.015f},  // run 6
-    {"Ne",  0.0001f},
-    {"Kr",  0.0001f}, // run 8
-    {"Xe",  0.0001f}
+constexpr float elementProb[GAS_COUNT] = {
+    0.965f,  // CO2, run 0
+    0.963f,  // H2
+    0.780f,  // N2, run 2
+    0.210f,  // O2
+    0.102f,  // He, run 4
+    0.016f,  // Ar
+    0.015f,  // CH4, run 6
+    0.0001f, // Ne
+    0.0001f, // Kr, run 8
+    0.0001f  // Xe
 };
 
 // atmosphere gas pressure
-std::map<std::string, float> ppMaxGas = {
-    {"He", 2934.0f},
-    {"Ne", 66.0f},
-    {"H2", 16.5f},
-    {"N2", 5.94f},
-    {"O2", 1.6f},
-    {"Ar", 1.12f},
-    {"Kr", 0.12f},
-    {"CO2", 0.015f},
-    {"Xe", 0.009f},
-    {"CH4", 0.001f}
+constexpr float ppMaxGas[GAS_COUNT] = {
+    0.015f,  // CO2
+    16.5f,   // H2
+    5.94f,   // N2
+    1.6f,    // O2
+    2934.0f, // He
+    1.12f,   // Ar
+    0.001f,  // CH4
+    66.0f,   // Ne
+    0.12f,   // Kr
+    0.009f   // Xe
 };
 
 // atmosphere element composition toxicity
-std::map<std::string, float> toxicity = {
-    {"He", 0.045f},
-    {"Ne", 0.3f},
-    {"H2", 0.6f},
-    {"N2", 1.0f},
-    {"O2", 1.7f},
-    {"Ar", 2.3f},
-    {"Kr", 7.1f},
-    {"CO2", 20.0f},
-    {"Xe", 25.6f},
-    {"CH4", 20.0f}
+constexpr float toxicity[GAS_COUNT] = {
+    20.0f,   // CO2
+    0.6f,    // H2
+    1.0f,    // N2
+    1.7f,    // O2
+    0.045f,  // He
+    2.3f,    // Ar
+    20.0f,   // CH4
+    0.3f,    // Ne
+    7.1f,    // Kr
+    25.6f    // Xe
 };
 
 
@@ -375,6 +1054,47 @@ std::map<std::string, float> toxicity = {
 // atmosphere data structure
 //-----------------------------------
 
+/**
+ * @brief Atmosphere element composition with one
+ * fixed slot per gas, indexed by AtmosphereGas.
+ * Names are only looked up when listing or serializing.
+ */
+struct AtmosphereComposition {
+
+    // volume part per gas
+    float parts[GAS_COUNT] = {};
+    // bit g set if gas g is part of the composition
+    uint16_t elements = 0;
+
+    // check if gas is part of the composition
+    bool has(const int gas) const {
+      return (elements>>gas) & 1u;
+    }
+
+    // volume part of gas (zero if not present)
+    float get(const int gas) const {
+      return parts[gas];
+    }
+
+    // set volume part of gas and add it to the composition
+    void set(const int gas, const float part) {
+      parts[gas] = part;
+      elements |= (uint16_t)(1u<<gas);
+    }
+
+    // number of gases in the composition
+    int size() const {
+      int count = 0;
+      for (int g=0; g<GAS_COUNT; ++g) { count += has(g); }
+      return count;
+    }
+
+    bool empty() const {
+      return elements==0;
+    }
+
+}; // end struct AtmosphereComposition
+
 /**
  * @brief Universe Atmosphere data structure.
  * Initialized to radius = 0
@@ -389,7 +1109,7 @@ struct UniverseAtmosphere {
     // pressure at surface in [atm]
     float pressure = 0;
     // element composition
-    std::map<std::string, float> composition = {};
+    AtmosphereComposition composition;
 
 
     //---------------------------
@@ -414,43 +1134,35 @@ struct UniverseAtmosphere {
  * Calculate atmosphere habitability percentage based on
  * breathable component percentage, for oxygen breathers,
  * atmospheric pressure, and maximum component concentration.
+ * All slots are checked without early exit, so the loop
+ * stays branch-light.
  * TODO: adapt to non-carbon based life forms and
  * non-oxygen breathers as required.
  * @param composition - object holding the elements
  * @param pressure - atmospheric pressure in [bar]
  * @return probabAtmo - probability of habiltability
  */
-float atmosphereHabitability(std::map<std::string, float> &composition, float pressure=1.0f) {
-    float probabAtmo = 1.0f;
-
-    int i = 0;
-    for (std::pair<std::string, float> element : composition) {
-      // Accessing KEY from record
-      std::string gas = element.first;
-      // Accessing VALUE from record.
-      float val = element.second;
-      //cout << i << ": " << gas << " :: " << val << " | ";
-      float ppGas = (float)val * pressure; 
-      if (ppGas>ppMaxGas[gas]) {
-          probabAtmo = 0.0f;
-      }
-      // the atmosphere is not breathable
-      if ((gas=="O2") & (ppGas<0.16f)) {
-          probabAtmo = 0.0f;
-      }
-      // atmosphere has no oxygen
-      if (composition.count("O2")==0) {
-          probabAtmo = 0.0f;
-      }
-      ++i;
+float atmosphereHabitability(const AtmosphereComposition &composition, float pressure=1.0f) {
+    // an empty composition has nothing to object
+    if (composition.empty()) { return 1.0f; }
+
+    // atmosphere has no oxygen
+    bool unbreathable = !composition.has(GAS_O2);
+    for (int gas=0; gas<GAS_COUNT; ++gas) {
+      float ppGas = composition.parts[gas] * pressure;
+      // partial pressure above the maximum
+      unbreathable |= composition.has(gas) & (ppGas>ppMaxGas[gas]);
     }
+    // the atmosphere is not breathable
+    unbreathable |= (composition.parts[GAS_O2] * pressure < 0.16f);
 
-    return probabAtmo;    
+    return unbreathable ? 0.0f : 1.0f;
 }
 
 /**
  * Concatenates composition element names up to a given string length and using
  * the defined separator.
+ * Elements are listed in alphabetical name order.
  * @param composition - object holding the elements
  * @param separator - separator string, e.g. "," or " "
  * @param bLong - return long or short Concatenated elements
@@ -458,18 +1170,14 @@ float atmosphereHabitability(std::map<std::string, float> &composition, float pr
  *   false will print elements only ("H2 He O2")
  * @return
  */
-std::string concatCompositionElements(std::map<std::string, float> &composition, std::string separator=" ", bool bLong=true) {
+std::string concatCompositionElements(const AtmosphereComposition &composition, std::string separator=" ", bool bLong=true) {
     std::string result = "";
     //uint maxLength = 10;
 
-    //cout << "DEBUG: ";
-    int i = 0;
-    for (std::pair<std::string, float> element : composition) {
-      // Accessing KEY from record
-      std::string key = element.first;
-      // Accessing VALUE from record.
-      float val = element.second;
-      //cout << i << ": " << key << " :: " << val << " | ";
+    for (int gas : componentNameOrder) {
+      if (!composition.has(gas)) { continue; }
+      const std::string &key = componentOrder[gas];
+      float val = composition.get(gas);
       if (bLong) { // long
         result += key + ":" + to_string(val) + separator;
       } else { // short
@@ -477,19 +1185,17 @@ std::string concatCompositionElements(std::map<std::string, float> &composition,
       }
       // we could implement maxLength checking;
       //if (result.length()>=maxLength) { break; }
-      ++i;
     }
-    //cout << "\n";
 
     return result;
 }
 
 /**
   * Creates atmosphere composition from typical elements.
-  * @param composition - atmo map object storing the composition
+  * @param composition - atmo object storing the composition
   * @param rnd - random generator
   */
-void createComposition(std::map<std::string, float> &composition, pcg32 rnd) {
+void createComposition(AtmosphereComposition &composition, pcg32 rnd) {
     //cout << "DEBUG: --- createComposition\n";
     // initial composition total volume percentage
     float part = 0.0f;
@@ -497,10 +1203,9 @@ void createComposition(std::map<std::string, float> &composition, pcg32 rnd) {
     int run = 0;
     // which element range to select. depends on the run (see below)
     int minCnt = 0;
-    int maxCnt = elementProb.size() - 1;
+    int maxCnt = GAS_COUNT - 1;
 
     while (part < 1.0f) {
-        //cout << "DEBUG: next part ... run = " << run << "\n";
         // which element range to select. depends on the run
         // one of the more frequent elements first
         // which of known composition elements to choose
@@ -514,21 +1219,14 @@ void createComposition(std::map<std::string, float> &composition, pcg32 rnd) {
         }
         if (run>1) {
             minCnt = 4;
-            maxCnt = elementProb.size() - 1;
+            maxCnt = GAS_COUNT - 1;
         }
-        //cout << "DEBUG: minCnt = " << minCnt << "\n";
-        //cout << "DEBUG: maxCnt = " << maxCnt << "\n";
 
         // which element?
         int which = minCnt + (int)rnd.nextUInt(maxCnt-minCnt);
-        //cout << "DEBUG: which element index = " << which << "\n";
-
-        //std::string comp = keys[which];
-        std::string comp = componentOrder[which];
-        //cout << "DEBUG: selected component = " << comp << "\n";
 
         // get maximum volume percentage
-        float maxPart = elementProb[comp];
+        float maxPart = elementProb[which];
         // get random volume percentage
         float variationPart = maxPart*0.6f + rnd.nextFloat() * maxPart*0.4f;
         // limit to the remaining volume percentage
@@ -536,17 +1234,12 @@ void createComposition(std::map<std::string, float> &composition, pcg32 rnd) {
         // add the new composition
         part += partToAdd;
 
-        //cout << "DEBUG: element exists count = " << composition.count(comp) << "\n";
-        if (composition.count(comp)) { //new
-          composition[comp] = partToAdd;
-        } else { // add
-          composition[comp] += partToAdd;
-        }
+        // a repeated element is replaced by the new part
+        composition.set(which, partToAdd);
 
         //cout << "DEBUG: maxPart = " << maxPart << "\n";
         //cout << "DEBUG: variationPart = " << variationPart << "\n";
         //cout << "DEBUG: partToAdd = " << partToAdd << "\n";
-        //cout << "DEBUG: total element part = " << composition[comp] << "\n";
         //cout << "DEBUG: total atmo = " << part << "\n";
 
         // next component run
@@ -726,6 +1419,21 @@ struct UniversePlanet {
 
 }; // end struct
 
+/**
+ * @brief Orbit of a planet from the layout pass of
+ * genPlanets (see genPlanetOrbits). With its orbit a
+ * planet is generated independently of its siblings.
+ */
+struct PlanetOrbit {
+  // planet seed
+  uint64_t seed = 0;
+  // distance from the star in [au]
+  float distanceAu = 0;
+  // inner limit of the mass accretion in [au],
+  // the outer limit of the previous planet
+  float lowerLimitAu = 0;
+};
+
 
 //---------------------------
 // UniversePlanet functions
@@ -753,13 +1461,17 @@ struct UniversePlanet {
   * @return planetTemperature in [K]
   */
 float planetTemperature(float Lstar, float distAu) {
-    float Aabs_Arad = 0.25f;
-    float albedo = 0.0f; // Earth = 0.29f;
-    float eta = 1.0f;    // Earth = 0.96f;
+    float Aabs_Arad = planetAabs_Arad;
+    float albedo = planetAlbedo;
+    float eta = planetEta;
     float L = Lstar * Lsol;
     //float result = pow( Aabs_Arad * (L * (1.0f - albedo) / (4 * M_PI * Lsigma * eta * pow(distKm*1e3f, 2.0f)) ), 0.25f );
     // TODO change distance to be in AU
-    float result = pow( Aabs_Arad * (L * (1.0f - albedo) / (4 * M_PI * Lsigma * eta * pow(distAu*au2km*1e3f, 2.0f)) ), 0.25f );
+    //float result = pow( Aabs_Arad * (L * (1.0f - albedo) / (4 * M_PI * Lsigma * eta * pow(distAu*au2km*1e3f, 2.0f)) ), 0.25f );
+    // square and fourth root written out, as optimizing compilers
+    // fold the pow calls, so that all builds give the same result
+    float distM = distAu*au2km*1e3f;
+    float result = sqrt(sqrt( Aabs_Arad * (L * (1.0f - albedo) / (4 * M_PI * Lsigma * eta * (distM*distM)) ) ));
     return result;
 }
 
@@ -772,16 +1484,16 @@ float planetTemperature(float Lstar, float distAu) {
   * @param hzMaxAu
   * @return
   */
-int getPlanetTypeIndex(UniversePlanet &planet, float hzMinAu, float hzMaxAu) {
+int getPlanetTypeIndex(float starDistance, float mass, float hzMinAu, float hzMaxAu) {
     
     // Warm Zone - default temperature zone
     int iZoneIdx = 6;
     // Hot Zone - water evaporates above evaporation point
-    if (planet.starDistance < hzMinAu) {
+    if (starDistance < hzMinAu) {
         iZoneIdx = 0;
     }
     // Cold Zone - water can only exist in ice form below freezing point
-    if (planet.starDistance > hzMaxAu) {
+    if (starDistance > hzMaxAu) {
         iZoneIdx = 12;
     }
 
@@ -789,7 +1501,7 @@ int getPlanetTypeIndex(UniversePlanet &planet, float hzMinAu, float hzMaxAu) {
     // Mercurian, Subterran, Terran, Superterran, Neptunian, Jovian
     int iMassIdx = 0;
     for (int i=0; i<6; i++) {
-        if ( (planet.mass/Mearth > Mearth_min[i]) & (planet.mass/Mearth < Mearth_max[i]) ) {
+        if ( (mass/Mearth > Mearth_min[i]) & (mass/Mearth < Mearth_max[i]) ) {
             iMassIdx = i;
             continue;
         }
@@ -800,6 +1512,10 @@ int getPlanetTypeIndex(UniversePlanet &planet, float hzMinAu, float hzMaxAu) {
     return typeIndex;
 }
 
+int getPlanetTypeIndex(UniversePlanet &planet, float hzMinAu, float hzMaxAu) {
+    return getPlanetTypeIndex(planet.starDistance, planet.mass, hzMinAu, hzMaxAu);
+}
+
 std::string getPeriodicType(int typeIndex) {
     if (typeIndex>-1) {
         return planetType[typeIndex];
@@ -857,6 +1573,80 @@ UniverseAtmosphere createAtmosphere(int typeIndex, float planetRadius, pcg32 &rn
     return atmosphere;
 }
 
+/**
+  * Advances the random generator past the draws of
+  * createAtmosphere without creating the atmosphere.
+  * The composition draws from a copy of the generator
+  * and is not skipped.
+  */
+void skipAtmosphere(int typeIndex, pcg32 &rnd) {
+    float atmProb = rnd.nextFloat();
+    if (atmProb>atmosphereProbabilityMax[typeIndex]) { return; }
+    // atmosphere radius (terrestial only) and pressure
+    rnd.advance(getPeriodicTypeColumn(typeIndex) <= 3 ? 2 : 1);
+}
+
+/**
+ * @brief Physiological limits for planet habitability,
+ * defaults for humans.
+ */
+struct HabitabilityLimits {
+    // surface temperature limits in [K], -50C to 50C
+    float temperatureMin = 223.0f;
+    float temperatureMax = 323.0f;
+    // well-being temperature in [K], 20C
+    float temperatureBest = 293.0f;
+    // temperature deviation from best to zero probability in [K]
+    float temperatureRange = 70.0f;
+    // relative surface gravity limits in [g]
+    float gravityMin = 0.2f;
+    float gravityMax = 3.0f;
+    // gravity deviation from 1g to zero probability in [g]
+    float gravityRange = 2.0f;
+};
+
+/**
+ * @brief Probability of a surface temperature
+ * within human physiology.
+ * @param temperature - surface temperature in [K]
+ */
+float temperatureProbability(float temperature, const HabitabilityLimits &limits = HabitabilityLimits()) {
+    // physiological limits -50C to 50C
+    if ( (temperature<limits.temperatureMin) | (temperature>limits.temperatureMax) ) {
+        return 0.0f;
+    }
+    // well-being at 20C=293
+    return 1.0f - abs(limits.temperatureBest-temperature)/limits.temperatureRange;
+}
+
+/**
+ * @brief Relative surface gravity of a planet in [g].
+ * @param mass - planet mass in [kg]
+ * @param radius - planet radius in [km]
+ */
+float planetRelativeGravity(float mass, float radius) {
+    float grel = 0.0f;
+    if ( (mass!=0) & (radius!=0) ) {
+        float radiusM = radius*1e3f;
+        grel = (G * mass / (radiusM*radiusM)) / gEarth;
+    }
+    return grel;
+}
+
+/**
+ * @brief Probability of a surface gravity
+ * within human physiology.
+ * @param grel - relative surface gravity in [g]
+ */
+float gravityProbability(float grel, const HabitabilityLimits &limits = HabitabilityLimits()) {
+    // physiological limits 0.2g to 3g
+    if ( (grel<limits.gravityMin) | (grel>limits.gravityMax) ) {
+        return 0.0f;
+    }
+    // well-being at 1g
+    return 1.0f - abs(1.0f-grel)/limits.gravityRange;
+}
+
 /**
  * @brief Estimates planet habitability probability
  * without technological aids.
@@ -880,39 +1670,14 @@ UniverseAtmosphere createAtmosphere(int typeIndex, float planetRadius, pcg32 &rn
  * TODO: Ptemp can be enhanced with checking for
  * equator or pole temperature to be in habitable range.
 **/
-void calcPlanetHabitability(UniversePlanet &planet) {
+void calcPlanetHabitability(UniversePlanet &planet, const HabitabilityLimits &limits = HabitabilityLimits()) {
     //cout << "DEBUG: --- calcPlanetHabitability\n";
-
-    // physiological limits -50C to 50C
-    if ( (planet.temperature<223) | (planet.temperature>323) ) {
-        planet.probTemp = 0.0f;
-        //return 0f;
-    } else {
-        // well-being at 20C=293
-        planet.probTemp = 1.0f - abs(293-planet.temperature)/70.0f;
-    }
-    //cout << "DEBUG: planet.probTemp = " << planet.probTemp << "\n";
-
-    // relative surface gravity
-    float grel = 0.0f;
-    if ( (planet.mass!=0) & (planet.radius!=0) ) {
-        grel = (G * planet.mass / pow(planet.radius*1e3f, 2.0f)) / gEarth;
-    }
-    //cout << "DEBUG: grel = " << grel << "\n";
-
-    // physiological limits 0.2g to 3g
-    if ( (grel<0.2f) | (grel>3.0f) ) {
-        planet.probGrav = 0.0f;
-    } else {
-        // well-being at 20C=293K
-        planet.probGrav = 1.0f - abs(1.0f-grel)/2.0f;
-    }
-    //cout << "DEBUG: planet.probGrav = " << planet.probGrav << "\n";
-
+    planet.probTemp = temperatureProbability(planet.temperature, limits);
+    planet.probGrav = gravityProbability(planetRelativeGravity(planet.mass, planet.radius), limits);
 }
 
-float getPlanetHabitability(UniversePlanet &planet) {
-    calcPlanetHabitability(planet);
+float getPlanetHabitability(UniversePlanet &planet, const HabitabilityLimits &limits = HabitabilityLimits()) {
+    calcPlanetHabitability(planet, limits);
     if (!planet.isInHz) {
         return 0.0f;
     }
@@ -924,6 +1689,107 @@ float getPlanetHabitability(UniversePlanet &planet) {
 
 }
 
+/**
+ * @brief Calculates temperature, relative gravity and
+ * habitability of many planets.
+ * Results are identical to planetTemperature,
+ * calcPlanetHabitability and getPlanetHabitability per planet.
+ * Uses AVX2 or SSE2 for groups of four planets when available.
+ * Inputs per planet:
+ * @param starLuminosity - host star luminosity in [Lsol]
+ * @param distanceAu - distance from the star in [au]
+ * @param mass - planet mass in [kg]
+ * @param radius - planet radius in [km]
+ * @param factor - habitability factor of location and atmosphere,
+ *   0 if not in the habitable zone, else the atmosphere
+ *   habitability or 1 without atmosphere
+ * Outputs per planet:
+ * @param temperature - surface temperature in [K]
+ * @param grel - relative surface gravity in [g]
+ * @param probTemp - temperature probability
+ * @param probGrav - gravity probability
+ * @param score - habitability, as getPlanetHabitability
+ * @param count - number of planets
+ * @param limits - physiological limits
+ */
+void planetHabitabilityBatch(
+    const float *starLuminosity, const float *distanceAu,
+    const float *mass, const float *radius, const float *factor,
+    float *temperature, float *grel, float *probTemp, float *probGrav, float *score,
+    size_t count, const HabitabilityLimits &limits = HabitabilityLimits()) {
+    // constant parts of planetTemperature, in its precision
+    const double radiation = 4 * M_PI * Lsigma * planetEta;
+    const float absorbed = 1.0f - planetAlbedo;
+    const double Aabs_Arad = planetAabs_Arad;
+    size_t p = 0;
+#if defined(PROCU_SIMD_SSE2)
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; p+4 <= count; p += 4) {
+        // temperature, with the square and fourth root in double
+        __m128 L = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(starLuminosity+p), _mm_set1_ps(Lsol)),
+            _mm_set1_ps(absorbed));
+        __m128 distance = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(distanceAu+p),
+            _mm_set1_ps(au2km)), _mm_set1_ps(1e3f));
+        __m128 distance2 = _mm_mul_ps(distance, distance);
+  #if defined(PROCU_SIMD_AVX2)
+        __m256d x = _mm256_div_pd(_mm256_cvtps_pd(L),
+            _mm256_mul_pd(_mm256_set1_pd(radiation), _mm256_cvtps_pd(distance2)));
+        x = _mm256_mul_pd(_mm256_set1_pd(Aabs_Arad), x);
+        __m128 t = _mm256_cvtpd_ps(_mm256_sqrt_pd(_mm256_sqrt_pd(x)));
+  #else
+        // two planets per double register
+        __m128 tHalf[2];
+        for (int h = 0; h < 2; h++) {
+            __m128 LHalf = h==0 ? L : _mm_movehl_ps(L, L);
+            __m128 distanceHalf = h==0 ? distance2 : _mm_movehl_ps(distance2, distance2);
+            __m128d x = _mm_div_pd(_mm_cvtps_pd(LHalf),
+                _mm_mul_pd(_mm_set1_pd(radiation), _mm_cvtps_pd(distanceHalf)));
+            x = _mm_mul_pd(_mm_set1_pd(Aabs_Arad), x);
+            tHalf[h] = _mm_cvtpd_ps(_mm_sqrt_pd(_mm_sqrt_pd(x)));
+        }
+        __m128 t = _mm_movelh_ps(tHalf[0], tHalf[1]);
+  #endif
+        // temperature probability
+        __m128 outside = _mm_or_ps(_mm_cmplt_ps(t, _mm_set1_ps(limits.temperatureMin)),
+            _mm_cmpgt_ps(t, _mm_set1_ps(limits.temperatureMax)));
+        __m128 deviation = _mm_andnot_ps(sign, _mm_sub_ps(_mm_set1_ps(limits.temperatureBest), t));
+        __m128 pTemp = _mm_sub_ps(one, _mm_div_ps(deviation, _mm_set1_ps(limits.temperatureRange)));
+        pTemp = _mm_andnot_ps(outside, pTemp);
+
+        // relative surface gravity
+        __m128 m = _mm_loadu_ps(mass+p);
+        __m128 r = _mm_mul_ps(_mm_loadu_ps(radius+p), _mm_set1_ps(1e3f));
+        __m128 g = _mm_div_ps(_mm_div_ps(_mm_mul_ps(_mm_set1_ps(G), m), _mm_mul_ps(r, r)),
+            _mm_set1_ps(gEarth));
+        __m128 valid = _mm_and_ps(_mm_cmpneq_ps(m, zero), _mm_cmpneq_ps(r, zero));
+        g = _mm_and_ps(valid, g);
+
+        // gravity probability
+        outside = _mm_or_ps(_mm_cmplt_ps(g, _mm_set1_ps(limits.gravityMin)),
+            _mm_cmpgt_ps(g, _mm_set1_ps(limits.gravityMax)));
+        deviation = _mm_andnot_ps(sign, _mm_sub_ps(one, g));
+        __m128 pGrav = _mm_sub_ps(one, _mm_div_ps(deviation, _mm_set1_ps(limits.gravityRange)));
+        pGrav = _mm_andnot_ps(outside, pGrav);
+
+        _mm_storeu_ps(temperature+p, t);
+        _mm_storeu_ps(grel+p, g);
+        _mm_storeu_ps(probTemp+p, pTemp);
+        _mm_storeu_ps(probGrav+p, pGrav);
+        _mm_storeu_ps(score+p, _mm_mul_ps(_mm_mul_ps(pTemp, pGrav), _mm_loadu_ps(factor+p)));
+    }
+#endif
+    // remaining planets
+    for (; p < count; p++) {
+        temperature[p] = planetTemperature(starLuminosity[p], distanceAu[p]);
+        grel[p] = planetRelativeGravity(mass[p], radius[p]);
+        probTemp[p] = temperatureProbability(temperature[p], limits);
+        probGrav[p] = gravityProbability(grel[p], limits);
+        score[p] = probTemp[p] * probGrav[p] * factor[p];
+    }
+}
+
 
 //-----------------------------------
 // Model of Universe Star
@@ -979,7 +1845,7 @@ float getPlanetHabitability(UniversePlanet &planet) {
 /**
   * spectralClass
   */
-std::list<std::string> spectralClass = {
+constexpr const char* spectralClass[24] = {
   "B", "A", "F",  // B,A,F I
   "G", "K", "M",  // G,K,M I
   "G", "K", "M",  // G,K,M III
@@ -993,7 +1859,7 @@ std::list<std::string> spectralClass = {
 /**
   * LuminosityClass
   */
-std::list<std::string> luminosityClass = {
+constexpr const char* luminosityClass[24] = {
   "I", "I", "I",        // B,A,F I
   "I", "I", "I",        // G,K,M I
   "III", "III", "III",  // G,K,M III
@@ -1004,7 +1870,7 @@ std::list<std::string> luminosityClass = {
   "", "", ""            // N, S, W 
 };
 
-std::list<string> starDesignation = {
+constexpr const char* starDesignation[24] = {
   "blue supergiant", "supergiant", "supergiant",      // B,A,F I
   "supergiant", "red supergiant", "red supergiant",   // G,K,M I
   "regular giant", "regular giant", "regular giant",  // G, K, M III
@@ -1023,7 +1889,7 @@ std::list<string> starDesignation = {
   * Data is kept for reference only
   * and not used in this library.
   *
-std::list<float> starTypeProbabilitySource = {
+constexpr float starTypeProbabilitySource[24] = {
   0.10f, 0.10f, 0.10f,   // B,A,F I
   0.10f, 0.10f, 0.10f,   // G,K,M I
   0.10f, 0.10f, 0.10f,   // G,K,M III
@@ -1034,7 +1900,7 @@ std::list<float> starTypeProbabilitySource = {
   0.01f, 0.01f, 0.01f    // N, S, W  
 };*/
 
-std::list<float> probabilityAge = {
+constexpr float probabilityAge[24] = {
   0.10f, 0.10f, 0.10f,   // B,A,F I
   0.10f, 0.10f, 0.10f,   // G,K,M I
   0.10f, 0.10f, 0.10f,   // G,K,M III
@@ -1049,7 +1915,7 @@ std::list<float> probabilityAge = {
  * starType probability
  * cumulative distribution function (cdf)
  */
-std::list<float> starTypeProbability = {
+constexpr float starTypeProbability[24] = {
   0.015152,  0.030303,  0.045455,   // B,A,F I
   0.060606,  0.075758,  0.090909,   // G,K,M I
   0.106061,  0.121212,  0.136364,   // G,K,M III
@@ -1060,10 +1926,16 @@ std::list<float> starTypeProbability = {
   0.996970,  0.998485,  1.000000    // N, S, W 
 };
 
+/**
+ * starType constant time sampler
+ * built from starTypeProbability
+ */
+constexpr CdfSampler<24> starTypeSampler(starTypeProbability);
+
 /**
   * minimum radius in [Rsol]
   */
-list<float> minRadius = {
+constexpr float minRadius[24] = {
     30.0f, 30.0f, 30.0f, 30.0f, 25.0f, 11.0f, // I B, A, F, G, K, M
     20.0f, 15.0f, 10.0f, // III G, K, M
     6.6f, 1.8f, 1.4f, // V O, B, A
@@ -1075,7 +1947,7 @@ list<float> minRadius = {
 /**
  * maximum radius in [Rsol]
  */
-list<float> maxRadius = {
+constexpr float maxRadius[24] = {
     2000.0f, 1900.0f, 1800.0f, 1700.0f, 1600.0f, 1.0f, // I B, A, F, G, K, M
     200.0f, 50.0f, 30.0f, // III G, K, M
     30.0f, 6.6f, 1.8f, // V O, B, A
@@ -1090,7 +1962,7 @@ list<float> maxRadius = {
 // unexperimented and unfathomed reason
 /*
 // minimum luminosity in [Lsol]
-list<float> minLuminosity = {
+constexpr float minLuminosity[24] = {
     6100.0f, 36000.0f, 12000.0f, 9500.0f, 12000.0f, 52000.0f, // B, A, F, G, K, M I
     113.0f, 32.0f, 3.3f, // G, K, M III
     55000.0f, 42.0f, 8.8f, // O, B, A V
@@ -1099,7 +1971,7 @@ list<float> minLuminosity = {
     1.0e-6f, 1.0e-6f, 1.0e-6f, 1.0e-6f // R, N, S, W
 };
 // maximum luminosity in [Lsol]
-list<float> maxLuminosity = {
+constexpr float maxLuminosity[24] = {
     320000.0f, 50600.0f, 20000.0f, 11000.0f, 20000.0f, 270000.0f, // B, A, F, G, K, M I
     127.0f, 96.0f, 15.0f, // G, K, M III
     200000.0f, 24000.0f, 24.0f, // O, B, A V
@@ -1112,7 +1984,7 @@ list<float> maxLuminosity = {
 /**
  * minimum mass in [Msol]
  */
-list<float> minMass = {
+constexpr float minMass[24] = {
     10.0f, 5.0f, 4.0f, 3.0f, 2.0f, 7.0f, // B, A, F, G, K, M I
     30.0f, 20.0f, 3.0f, // G, K, M III
     16.0f, 2.1f, 1.4f, // O, B, A V
@@ -1124,7 +1996,7 @@ list<float> minMass = {
 /**
  * maximum mass in [Msol]
  */
-list<float> maxMass = {
+constexpr float maxMass[24] = {
     100.0f, 30.0f, 20.0f, 11.0f, 40.0f, 40.0f, // B, A, F, G, K, M I
     100.0f, 70.0f, 15.0f, // G, K, M III
     200.0f, 24000.0f, 2.1f, // O, B, A V
@@ -1136,7 +2008,7 @@ list<float> maxMass = {
 /**
  * minimum effective temperature in [K]
  */
-list<float> minTemperature = {
+constexpr float minTemperature[24] = {
     9700.0f, 8300.0f, 6150.0f, 5050.0f, 3750.0f, 2950.0f, // B, A, F, G, K, M I
     4870.0f, 3780.0f, 2800.0f, // G, K, M III
     3780.0f, 11400.0f, 7920.0f, // O, B, A V
@@ -1148,7 +2020,7 @@ list<float> minTemperature = {
 /**
  * maximum effective temperature in [K]
  */
-list<float> maxTemperature = {
+constexpr float maxTemperature[24] = {
     21000.0f, 9400.0f, 7500.0f, 5800.0f, 4900.0f, 3690.0f, // B, A, F, G, K, M I
     5010.0f, 4720.0f, 3660.0f, // G, K, M III
     54000.0f, 29200.0f, 9600.0f, // O, B, A V
@@ -1164,7 +2036,7 @@ list<float> maxTemperature = {
  * like e.g. colot index = -2.5 log (temperature).
  * see also https://docs.kde.org/trunk5/en/extragear-edu/kstars/ai-colorandtemp.html
  */
-list<vector<float>> apparentColors = {
+constexpr float apparentColors[24][3] = {
   { 0.906f, 0.878f, 1.000f }, // B I
   { 0.792f, 0.749f, 0.929f }, // A I
   { 0.992f, 0.992f, 0.925f }, // F I
@@ -1230,13 +2102,12 @@ struct UniverseStar {
   std::vector<double> position = {0.0, 0.0, 0.0};
 
   // stellar type, e.g. "G2V", or "M5V"
-  // sectral class ("M") + temperatur sequence ("5.5") + luminosity class ("V")
+  // sectral class ("M") + temperatur sequence ("5") + luminosity class ("V")
+  // the strings are looked up from typeIndex and temperatureSubclass,
+  // see getStellarType(star) and related functions
   uint typeIndex = 0;
-  std::string spectralClass = "";
-  std::string temperatureSequence = "";
-  std::string luminosityClass = "";
-  std::string stellarType = "";
-  std::string designation = "";
+  // temperature subclass [0..9], 0 - hottest
+  int8_t temperatureSubclass = 0;
   // mass in [Msol]
   float mass = 0;
   // luminosity in [Lsol]
@@ -1312,16 +2183,17 @@ struct UniverseStar {
   * @param starMass - star mass in [Msol]
   * @param frostLimitAu - frost limit distance from star in [au]
   * @param posAu - distance from star to get mass density at in [au]
+  * @param fastMath - use the approximate math functions
   * @return massDensity - mass density in [kg*au^-1]
   */
-float getStarMassDensity(float starMass, float frostLimitAu, float posAu) {
+float getStarMassDensity(float starMass, float frostLimitAu, float posAu, bool fastMath=false) {
     float massDensity = 0.0f;
     if (posAu<frostLimitAu) {
         // inside of frost limit
-        massDensity = 4.2e24f * (starMass) * normalDistribution(posAu, frostLimitAu / 2.0f, frostLimitAu / 16.0f);
+        massDensity = 4.2e24f * (starMass) * normalDistribution(posAu, frostLimitAu / 2.0f, frostLimitAu / 16.0f, fastMath);
     } else {
         // outside of frost limit
-        massDensity = 8.0e26f * (starMass) * inverseExpDistribution(posAu, 0.5f);
+        massDensity = 8.0e26f * (starMass) * inverseExpDistribution(posAu, 0.5f, fastMath);
     }
     return massDensity;
 }
@@ -1340,10 +2212,43 @@ float calcFrostLimit(float lumStar) {
 }
 
 /**
-  * @brief Calculate the habitable zone parameters of a
-  * star given the photospheric temperature tEff in
-  * degrees Kelvin [K] and the stellar luminosity in
-  * solar units [Lsol] for F, K, G, and M type stars
+  * Coeffcients to be used in the analytical expression
+  * to calculate habitable zone flux boundaries for each
+  * habitable zone limit, as given in the Kopparapu et al. paper,
+  * index 1 to 7 by HZ limit (see habitableZoneComplete).
+  */
+constexpr float hzSeffSun[8] = {
+    0.0f, 1.7763f, 1.0385f, 1.0146f, 0.3507f, 0.3207f, 0.2484f, 0.5408f
+};
+constexpr float hzCoeffA[8] = {
+    0.0f, 1.4335e-4f, 1.2456e-4f, 8.1884e-5f, 5.9578e-5f, 5.4471e-5f, 4.2588e-5f, 4.4499e-5f
+};
+constexpr float hzCoeffB[8] = {
+    0.0f, 3.3954e-9f, 1.4612e-8f, 1.9394e-9f, 1.6707e-9f, 1.5275e-9f, 1.1963e-9f, 1.4065e-10f
+};
+constexpr float hzCoeffC[8] = {
+    0.0f, -7.6364e-12f, -7.6345e-12f, -4.3618e-12f, -3.0058e-12f, -2.7481e-12f, -2.1709e-12f, -2.2750e-12f
+};
+constexpr float hzCoeffD[8] = {
+    0.0f, -1.1950e-15f, -1.7511E-15f, -6.8260e-16f, -5.1925e-16f, -4.7474e-16f, -3.8282e-16f, -3.3509e-16f
+};
+
+/**
+  * Coefficient row used for each result column.
+  * The former per call coefficient arrays were initialized
+  * shifted by one limit (column i used the coefficients
+  * of limit i+1, and column 7 those of limit 7).
+  * The mapping is kept so that generated stars stay unchanged.
+  */
+constexpr int hzLimitIndex[8] = {
+    0, 2, 3, 4, 5, 6, 7, 7
+};
+
+/**
+  * @brief Calculate the habitable zone parameters of a
+  * star given the photospheric temperature tEff in
+  * degrees Kelvin [K] and the stellar luminosity in
+  * solar units [Lsol] for F, K, G, and M type stars
   * with temparature range from 2600K to 7200K.
   *
   * This code calculates habitable zone 'fluxes' using
@@ -1374,85 +2279,99 @@ float calcFrostLimit(float lumStar) {
   * @author Ravi Kumar Kopparapu 2012-02-25
   */
 void habitableZoneComplete(float (&hzDistAu)[8], float tEff, float lumStar) {
-    /*
-      * Coeffcients to be used in the analytical expression
-      * to calculate habitable zone flux boundaries for each
-      * habitable zone limit.
-    **/
-
-    float seffsun [8] = {
-      seffsun[1] = 1.7763f,
-      seffsun[2] = 1.0385f,
-      seffsun[3] = 1.0146f,
-      seffsun[4] = 0.3507f,
-      seffsun[5] = 0.3207f,
-      seffsun[6] = 0.2484f,
-      seffsun[7] = 0.5408f
-    };
-
-    float a [8] = {
-      a[1] = 1.4335e-4f,
-      a[2] = 1.2456e-4f,
-      a[3] = 8.1884e-5f,
-      a[4] = 5.9578e-5f,
-      a[5] = 5.4471e-5f,
-      a[6] = 4.2588e-5f,
-      a[7] = 4.4499e-5f
-    };
-
-    float b [8] = {
-      b[1] = 3.3954e-9f,
-      b[2] = 1.4612e-8f,
-      b[3] = 1.9394e-9f,
-      b[4] = 1.6707e-9f,
-      b[5] = 1.5275e-9f,
-      b[6] = 1.1963e-9f,
-      b[7] = 1.4065e-10f
-    };
-
-    float c [8] = {
-      c[1] = -7.6364e-12f,
-      c[2] = -7.6345e-12f,
-      c[3] = -4.3618e-12f,
-      c[4] = -3.0058e-12f,
-      c[5] = -2.7481e-12f,
-      c[6] = -2.1709e-12f,
-      c[7] = -2.2750e-12f
-    };
-
-    float d [8] = {
-      d[1] = -1.1950e-15f,
-      d[2] = -1.7511E-15f,
-      d[3] = -6.8260e-16f,
-      d[4] = -5.1925e-16f,
-      d[5] = -4.7474e-16f,
-      d[6] = -3.8282e-16f,
-      d[7] = -3.3509e-16f
-    };
-
     /**
       * Calculating HZ fluxes for stars with 2600 K < T_eff < 7200 K.
     **/
     // calculate the stellar fluxes
     float tStar = tEff - 5780.0f;
-    float sEff [8];
-    for (int i = 1; i < 8; i++) {
-          sEff[i] = max((double)(seffsun[i] + a[i]*tStar + b[i]*pow(tStar,2) + c[i]*pow(tStar,3) + d[i]*pow(tStar,4)), 0.0);
-    }
+    double t = tStar;
 
     // calculate the hz distances from star in [au]
     hzDistAu[0] = 0.0;
     for (int i = 1; i < 8; i++) {
-        if (sEff[i]==0.0f) {
+        int k = hzLimitIndex[i];
+        // seffsun + a*t in float, higher orders in double (Horner)
+        float linear = hzSeffSun[k] + hzCoeffA[k]*tStar;
+        double higher = t*t * (hzCoeffB[k] + t*(hzCoeffC[k] + t*(double)hzCoeffD[k]));
+        float sEff = max(linear + higher, 0.0);
+        if (sEff==0.0f) {
             hzDistAu[i] = 0.0f;
         } else {
-            hzDistAu[i] = sqrt(lumStar/sEff[i]);
+            hzDistAu[i] = sqrt(lumStar/sEff);
         }
         //cout << "hzDistAu[" << i << "] = " << hzDistAu[i] << "\n";
     }
 
 }
 
+/**
+  * @brief Calculates the habitable zone limits of many stars.
+  * Results are identical to habitableZoneComplete per star
+  * (checked for all float temperatures in [400..60000] K).
+  * Uses AVX2 or SSE2 for groups of four stars when available.
+  * @param tEff - photospheric temperatures [K], count values
+  * @param lumStar - luminosities [Lsol], count values
+  * @param hzDistAu - results, 8 per star in the order
+  *   of habitableZoneComplete (count*8 values)
+  * @param count - number of stars
+  */
+void habitableZoneBatch(const float *tEff, const float *lumStar, float *hzDistAu, size_t count) {
+    size_t s = 0;
+#if defined(PROCU_SIMD_SSE2)
+    for (; s+4 <= count; s += 4) {
+        __m128 tStar = _mm_sub_ps(_mm_loadu_ps(tEff+s), _mm_set1_ps(5780.0f));
+        __m128 lum = _mm_loadu_ps(lumStar+s);
+        alignas(16) float limits[8][4] = {};
+        for (int i = 1; i < 8; i++) {
+            int k = hzLimitIndex[i];
+            __m128 linear = _mm_add_ps(_mm_set1_ps(hzSeffSun[k]),
+                _mm_mul_ps(_mm_set1_ps(hzCoeffA[k]), tStar));
+  #if defined(PROCU_SIMD_AVX2)
+            __m256d t = _mm256_cvtps_pd(tStar);
+            __m256d higher = _mm256_add_pd(_mm256_set1_pd(hzCoeffC[k]),
+                _mm256_mul_pd(t, _mm256_set1_pd(hzCoeffD[k])));
+            higher = _mm256_add_pd(_mm256_set1_pd(hzCoeffB[k]), _mm256_mul_pd(t, higher));
+            higher = _mm256_mul_pd(_mm256_mul_pd(t, t), higher);
+            __m256d sum = _mm256_max_pd(
+                _mm256_add_pd(_mm256_cvtps_pd(linear), higher), _mm256_setzero_pd());
+            __m128 sEff = _mm256_cvtpd_ps(sum);
+  #else
+            // two stars per double register
+            __m128 sEffHalf[2];
+            for (int h = 0; h < 2; h++) {
+                __m128 tHalf = h==0 ? tStar : _mm_movehl_ps(tStar, tStar);
+                __m128 linearHalf = h==0 ? linear : _mm_movehl_ps(linear, linear);
+                __m128d t = _mm_cvtps_pd(tHalf);
+                __m128d higher = _mm_add_pd(_mm_set1_pd(hzCoeffC[k]),
+                    _mm_mul_pd(t, _mm_set1_pd(hzCoeffD[k])));
+                higher = _mm_add_pd(_mm_set1_pd(hzCoeffB[k]), _mm_mul_pd(t, higher));
+                higher = _mm_mul_pd(_mm_mul_pd(t, t), higher);
+                __m128d sum = _mm_max_pd(
+                    _mm_add_pd(_mm_cvtps_pd(linearHalf), higher), _mm_setzero_pd());
+                sEffHalf[h] = _mm_cvtpd_ps(sum);
+            }
+            __m128 sEff = _mm_movelh_ps(sEffHalf[0], sEffHalf[1]);
+  #endif
+            // zero flux gives a zero distance
+            __m128 distance = _mm_sqrt_ps(_mm_div_ps(lum, sEff));
+            __m128 valid = _mm_cmpneq_ps(sEff, _mm_setzero_ps());
+            _mm_store_ps(limits[i], _mm_and_ps(distance, valid));
+        }
+        for (int j = 0; j < 4; j++) {
+            for (int i = 0; i < 8; i++) {
+                hzDistAu[8*(s+j)+i] = limits[i][j];
+            }
+        }
+    }
+#endif
+    // remaining stars
+    for (; s < count; s++) {
+        float limits[8];
+        habitableZoneComplete(limits, tEff[s], lumStar[s]);
+        std::copy(limits, limits+8, hzDistAu+8*s);
+    }
+}
+
 /**
  * @brief Checks if star has planets in the habitable zone
  */
@@ -1479,21 +2398,7 @@ bool hasPlanetsInHz(UniverseStar &star) {
   * @return int index
   */
 int getRndStarIdx(float rn) {
-  int idx = 0;
-  for(std::list<float>::iterator iter=starTypeProbability.begin(),
-      prev=starTypeProbability.end(); 
-      iter != starTypeProbability.end(); prev=iter, ++iter ) {
-    float ub = *iter; // upper bound
-    idx = std::distance(starTypeProbability.begin(), iter);
-    cout << idx << " ";
-    if (rn<=ub) { break; }
-    // compare with previous element
-    //if (prev != probCdf.end()) {
-      //prevEl = *prev }
-  }
-  //cout << "\n";
-  //cout << "star type: " << idx << "\n";
-  return idx;
+  return starTypeSampler.sample(rn);
 }
 
 /**
@@ -1503,12 +2408,21 @@ int getRndStarIdx(float rn) {
   * for .43 Msol < M < 2 Msol -> L/Lsol = M/Msol ^4
   * for 2 Msol < M < 20 Msol -> L/Lsol = 1.5 * M/Msol ^3.5
   * for 20 Msol < M -> L/Lsol = 3200 * M/Msol
+  * With fastMath, powers are taken with multiplications,
+  * sqrt and fastPow.
   */
-float calcLuminosity(float mass) {
+float calcLuminosity(float mass, bool fastMath=false) {
     float luminosity = 0.0;
     //if (mass == NULL) { return -1.0f; }
 
     float massMSol = mass; //  / Msol;
+    if (fastMath) {
+        float mass2 = massMSol * massMSol;
+        if (massMSol<0.43f) { return 0.23f * fastPow(massMSol, 2.3f); }
+        if (massMSol<2.0f) { return mass2 * mass2; }
+        if (massMSol<20.0f) { return 1.5f * (mass2 * massMSol * sqrt(massMSol)); }
+        return 3200.0f * massMSol;
+    }
     if (massMSol<0.43f) {
         luminosity = 0.23f * pow(massMSol, 2.3f);
     }
@@ -1581,6 +2495,107 @@ std::vector<byte> getStarColor(float starTemperatureK) {
   return {(byte)red, (byte)green, (byte)blue};
 }
 
+/**
+  * @brief Star color lookup table over the star
+  * temperature range [500..54000] K.
+  * Channel values of getStarColor are sampled every
+  * STEP_K Kelvin and linearly interpolated in between.
+  * The fit branches at 1900 K and 6600 K lie on grid
+  * nodes, and each segment is sampled with the branch
+  * of its interior, so the jumps of the fit at 6600 K
+  * are reproduced.
+  * Maximum deviation from getStarColor is 1 per channel
+  * (from truncation of interpolated values near integers),
+  * checked for every float temperature in the range.
+  * The only exception is green at exactly 6600 K, which the
+  * fit assigns to the lower branch and the table to the upper.
+  */
+struct StarColorTable {
+
+  static constexpr float MIN_K = 500.0f;
+  static constexpr float MAX_K = 54000.0f;
+  static constexpr float STEP_K = 10.0f;
+  static constexpr int SEGMENTS = (int)((MAX_K - MIN_K) / STEP_K);
+
+  // channel values at segment start and their change over
+  // the segment, rgb; not yet clamped to [0..255]
+  // so that clamping is exact after interpolation
+  float base[SEGMENTS][3];
+  float slope[SEGMENTS][3];
+
+  StarColorTable() {
+    for (int i=0; i<SEGMENTS; ++i) {
+      float lower = (MIN_K + i*STEP_K) / 100.0f;
+      float upper = (MIN_K + (i+1)*STEP_K) / 100.0f;
+      // branch of the segment interior
+      float branch = 0.5f * (lower + upper);
+      for (int c=0; c<3; ++c) {
+        base[i][c] = channel(c, branch, lower);
+        slope[i][c] = channel(c, branch, upper) - base[i][c];
+      }
+    }
+  }
+
+  /**
+   * @brief Unclamped getStarColor channel fit.
+   * @param c - channel, 0 red, 1 green, 2 blue
+   * @param branch - temperature / 100 selecting the fit branch
+   * @param temperature - temperature / 100 to evaluate
+   */
+  static float channel(int c, float branch, float temperature) {
+    switch (c) {
+      case 0:
+        return branch <= 66.0f ? 255.0f
+          : (float)(329.698727446 * pow(temperature - 60.0f, -0.1332047592));
+      case 1:
+        return branch <= 66.0f
+          ? (float)(99.4708025861 * log(temperature) - 161.1195681661)
+          : (float)(288.1221695283 * pow(temperature - 60.0f, -0.0755148492));
+      default:
+        return branch >= 66.0f ? 255.0f
+          : branch <= 19.0f ? 0.0f
+          : (float)(138.5177312231 * log(temperature - 10.0f) - 305.0447927307);
+    }
+  }
+
+  /**
+   * @brief Interpolated star color.
+   * @param starTemperatureK - clamped to [MIN_K..MAX_K]
+   * @return  vector of red, green and blue color values
+   */
+  std::vector<byte> color(float starTemperatureK) const {
+    float x = (min(max(starTemperatureK, MIN_K), MAX_K) - MIN_K) / STEP_K;
+    int i = min((int)x, SEGMENTS - 1);
+    float f = x - i;
+    byte result[3];
+    for (int c=0; c<3; ++c) {
+      float value = base[i][c] + f*slope[i][c];
+      result[c] = (byte)min(255.0f, max(0.0f, value));
+    }
+    return {result[0], result[1], result[2]};
+  }
+
+}; // end struct StarColorTable
+
+/**
+  * @brief Shared star color lookup table,
+  * built once on first use.
+  */
+const StarColorTable& getStarColorTable() {
+  static const StarColorTable table;
+  return table;
+}
+
+/**
+  * @brief Star color from the shared lookup table.
+  * See StarColorTable for the error bounds.
+  * @param   star temperature in Kelvin [K]
+  * @return  vector of red, green and blue color values
+  */
+std::vector<byte> getStarColorTabled(float starTemperatureK) {
+  return getStarColorTable().color(starTemperatureK);
+}
+
 /**
   * Stellar classification divides temperature classes into
   * subclasses named with arabic numerals and ranging from
@@ -1591,25 +2606,70 @@ std::vector<byte> getStarColor(float starTemperatureK) {
   * classes ranging between 0 and 9, and without
   * fractional numbers.
   **/
-std::string genStarTemperatureSequence(int idx, float temperature) {
-  std::string tempSeq = "";
-  //std::cout << "  ... fx | genStarTemperatureSequence\n";
-  float temperatureMin = *(std::next(minTemperature.begin(), idx));
-  float temperatureMax = *(std::next(maxTemperature.begin(), idx));
+int genStarTemperatureSubclass(int idx, float temperature) {
+  float temperatureMin = minTemperature[idx];
+  float temperatureMax = maxTemperature[idx];
   // step size for 10 steps
   float step = (temperatureMax-temperatureMin) / 10;
   // find step multiplier for input temp (0 - highest, 9 - lowest)
   float mult = (temperatureMax - temperature) / step;
-  tempSeq = to_string((int)mult);
+  return (int)mult;
+}
+
+/**
+  * @brief Temperature sequence string of the
+  * temperature subclass, e.g. "5".
+  */
+std::string genStarTemperatureSequence(int idx, float temperature) {
+  return to_string(genStarTemperatureSubclass(idx, temperature));
+}
+
+/**
+  * @brief Sets the stellar classification codes
+  * from star type index and temperature.
+  */
+void classifyStar(UniverseStar &star) {
+  star.temperatureSubclass = (int8_t)genStarTemperatureSubclass(star.typeIndex, star.temperature);
+}
+
+//-----------------------------------
+// star classification strings
+//-----------------------------------
+
+/**
+  * @brief Spectral class of the star, e.g. "G".
+  */
+const char* getSpectralClass(const UniverseStar &star) {
+  return spectralClass[star.typeIndex];
+}
+
+/**
+  * @brief Luminosity class of the star, e.g. "V".
+  */
+const char* getLuminosityClass(const UniverseStar &star) {
+  return luminosityClass[star.typeIndex];
+}
 
-  //std::cout << "  star temperature " << temperature << "\n";
-  //std::cout << "  temperatureMin " << temperatureMin << "\n";
-  //std::cout << "  temperatureMax " << temperatureMax << "\n";
-  //std::cout << "  step " << step << "\n";
-  //std::cout << "  mult " << mult << "\n";
-  //std::cout << "  mult (int) " << (int)mult << "\n";
-  //std::cout << "  ... return : " << tempSeq << "\n";
-  return tempSeq;
+/**
+  * @brief Designation of the star, e.g. "main-sequence".
+  */
+const char* getDesignation(const UniverseStar &star) {
+  return starDesignation[star.typeIndex];
+}
+
+/**
+  * @brief Temperature sequence of the star, e.g. "2".
+  */
+std::string getTemperatureSequence(const UniverseStar &star) {
+  return to_string(star.temperatureSubclass);
+}
+
+/**
+  * @brief Stellar type of the star, e.g. "G2V".
+  * spectral class + temperature sequence + luminosity class
+  */
+std::string getStellarType(const UniverseStar &star) {
+  return getSpectralClass(star) + getTemperatureSequence(star) + getLuminosityClass(star);
 }
 
 /**
@@ -1632,7 +2692,7 @@ float getHabitablePlanetsProbability(UniverseStar &star) {
 
     //get age probability from star type index
     // or throw "undefined probabilityAge for spectralType " << spectralType;
-    probAge = *(std::next(probabilityAge.begin(), star.typeIndex));
+    probAge = probabilityAge[star.typeIndex];
     // get output variation probability
     probVar = 1.0f - star.outputVariation;
     //std::cout << "DEBUG:  probAge " << probAge << "\n";
@@ -1704,7 +2764,7 @@ enum SystemMultiplicity {
  * This data is invented without any scientific basis.
  * TODO: research scientific probabilities
  */
-std::list<float> starSystemMultiProbability = {
+constexpr float starSystemMultiProbability[7] = {
   0.800,  // unary
   0.900,  // binary
   0.950,  // trinary
@@ -1714,6 +2774,12 @@ std::list<float> starSystemMultiProbability = {
   1.000   // septenary 
 };
 
+/**
+ * @brief multiple star system constant time sampler
+ * built from starSystemMultiProbability
+ */
+constexpr CdfSampler<7> starSystemMultiSampler(starSystemMultiProbability);
+
 //-----------------------------------
 // system data structure
 //-----------------------------------
@@ -1728,10 +2794,10 @@ std::list<float> starSystemMultiProbability = {
 struct UniverseSystem {
 
   // the seed is the system global unique identifier (GUID)
-  uint64_t seed;
+  uint64_t seed = 0;
 
   // the parent sector seed
-  uint64_t sector;
+  uint64_t sector = 0;
 
   // system coordinates within the parent sector cube
   // where (0,0,0) is cube's 'lower-left' coordinate\n";
@@ -1756,6 +2822,34 @@ struct UniverseSystem {
 
 }; // end struct
 
+/**
+ * @brief Map level summary of a system (32 bytes), see
+ * genSystemSummary. The fields equal those of the full
+ * generation, the position rounded to float.
+ */
+struct SystemSummary {
+
+  // the system seed
+  uint64_t seed = 0;
+  // system coordinates within the parent sector cube in [ly]
+  float position[3] = {0, 0, 0};
+  // dominant star photosphere temperature [K]
+  float temperature = 0;
+  // dominant star color rgb [0..255]
+  byte color[3] = {0, 0, 0};
+  // number of stars in the system
+  uint8_t multiplicity = 0;
+  // dominant star type index (spectralClass, luminosityClass)
+  uint8_t typeIndex = 0;
+  // dominant star temperature subclass [0..9]
+  int8_t temperatureSubclass = 0;
+  // dominant (most massive) star index in getStarSeeds
+  uint8_t dominantStar = 0;
+
+}; // end struct
+
+static_assert(sizeof(SystemSummary)==32, "SystemSummary is a 32 byte record");
+
 
 //-----------------------------------
 // Model of Universe Sector
@@ -1793,662 +2887,3872 @@ struct UniverseSector {
 }; // end struct
 
 
-//-----------------------------------
-// libProcU procu::ProcUGalaxy enum
-//-----------------------------------
+/**
+ * @brief Axis aligned box of sector coordinates.
+ * Minimum coordinates are inclusive, maximum
+ * coordinates are exclusive.
+ */
+struct SectorRegion {
+
+  int xMin = 0;
+  int yMin = 0;
+  int zMin = 0;
+  int xMax = 0;
+  int yMax = 0;
+  int zMax = 0;
+
+  // check if region holds no sectors
+  bool empty() const {
+    return (xMin>=xMax) | (yMin>=yMax) | (zMin>=zMax);
+  }
+
+  // number of sectors in region
+  uint64_t size() const {
+    if (empty()) { return 0; }
+    return (uint64_t)(xMax-xMin) * (uint64_t)(yMax-yMin) * (uint64_t)(zMax-zMin);
+  }
+
+  // check if sector coordinate is inside region
+  bool contains(const int x, const int y, const int z) const {
+    return (x>=xMin) & (x<xMax) & (y>=yMin) & (y<yMax) & (z>=zMin) & (z<zMax);
+  }
+
+  // overlapping part of both regions
+  SectorRegion intersect(const SectorRegion &other) const {
+    SectorRegion region;
+    region.xMin = max(xMin, other.xMin);
+    region.yMin = max(yMin, other.yMin);
+    region.zMin = max(zMin, other.zMin);
+    region.xMax = min(xMax, other.xMax);
+    region.yMax = min(yMax, other.yMax);
+    region.zMax = min(zMax, other.zMax);
+    return region;
+  }
+
+}; // end struct
 
 /**
- * Galaxy Types that can be generated
-**/
-enum GALAXY_TYPE {
-    SPIRAL   = 0,
-    GLOBULAR = 1
+ * @brief Sector coordinate with its derived seed
+ * as returned by the sector cursor.
+ */
+struct SectorCoordinate {
+  int x = 0;
+  int y = 0;
+  int z = 0;
+  uint64_t seed = 0;
 };
 
 
-//-----------------------------------
-// libProcU procu::ProcUGalaxy class
-//-----------------------------------
+//---------------------------------
+// sector keys
+//---------------------------------
 
 /**
- * @brief ProcUGalaxy\n
- * A galaxy procedural generator.
- * See documentation at the top of this library file.
- * 
- * @author pyramid
-**/
+  * @brief Spreads the lower 21 bits of a value to every
+  * third bit of the result.
+  */
+uint64_t mortonSpread(uint64_t v) {
+    v &= 0x1fffffull;
+    v = (v | (v << 32)) & 0x1f00000000ffffull;
+    v = (v | (v << 16)) & 0x1f0000ff0000ffull;
+    v = (v | (v << 8))  & 0x100f00f00f00f00full;
+    v = (v | (v << 4))  & 0x10c30c30c30c30c3ull;
+    v = (v | (v << 2))  & 0x1249249249249249ull;
+    return v;
+} // end function
 
-class ProcUGalaxy {
+/**
+  * @brief Gathers every third bit of a value
+  * (inverse of mortonSpread).
+  */
+uint64_t mortonCompact(uint64_t v) {
+    v &= 0x1249249249249249ull;
+    v = (v ^ (v >> 2))  & 0x10c30c30c30c30c3ull;
+    v = (v ^ (v >> 4))  & 0x100f00f00f00f00full;
+    v = (v ^ (v >> 8))  & 0x1f0000ff0000ffull;
+    v = (v ^ (v >> 16)) & 0x1f00000000ffffull;
+    v = (v ^ (v >> 32)) & 0x1fffffull;
+    return v;
+} // end function
+
+// sector coordinates are biased to 21 bit unsigned values
+const int SECTOR_KEY_BIAS = 1 << 20;
 
-private:
+/**
+  * @brief Z-order (Morton) key of a sector coordinate,
+  * for coordinates in [-2^20, 2^20) on each axis.
+  * Sectors close in space have close keys, and the
+  * key converts back with sectorCoordinate.
+  */
+uint64_t sectorKey(const int x, const int y, const int z) {
+    return (mortonSpread((uint64_t)(x + SECTOR_KEY_BIAS)) << 2)
+      | (mortonSpread((uint64_t)(y + SECTOR_KEY_BIAS)) << 1)
+      | mortonSpread((uint64_t)(z + SECTOR_KEY_BIAS));
+} // end function
+
+/**
+  * @brief Sector coordinate of a sectorKey.
+  * The seed is left zero (see ProcUGalaxy::getSectorSeed).
+  */
+SectorCoordinate sectorCoordinate(const uint64_t key) {
+    SectorCoordinate coordinate;
+    coordinate.x = (int)mortonCompact(key >> 2) - SECTOR_KEY_BIAS;
+    coordinate.y = (int)mortonCompact(key >> 1) - SECTOR_KEY_BIAS;
+    coordinate.z = (int)mortonCompact(key) - SECTOR_KEY_BIAS;
+    return coordinate;
+} // end function
+
+
+/**
+ * @brief Sectors keyed by sectorKey in an open addressing
+ * hash table with linear probing.
+ * Sectors are held in a dense array which sortByKey puts
+ * in Z-order, so that neighboring sectors are iterated
+ * (and exported) together; the slots only hold indices
+ * into that array.
+ */
+class SectorTable {
 
 public:
-  /// configuration variables
-  // galaxy size x, y, z
-  int GALAXY_TYPE = GALAXY_TYPE::SPIRAL;
-  std::vector<double> GALAXY_SIZE_LY{1.0e4, 100.0, 1.0e4};
-  double SECTOR_SIZE_LY = 10.0;
-  int MAX_SYSTEMS = 10;  // per sector
-  int MAX_STARS = 3;     // per system
-  int MAX_PLANETS = 10;  // per system
+  using value_type = std::pair<uint64_t, UniverseSector>;
+  using iterator = std::vector<value_type>::iterator;
+  using const_iterator = std::vector<value_type>::const_iterator;
 
-  // the galaxy seed is global
-  uint64_t galaxySeed;
+private:
+  // sectors with their keys
+  std::vector<value_type> entries;
+  // entry index + 1 per slot, 0 for an empty slot
+  std::vector<uint32_t> slots;
+
+  // slot holding the key, or the empty slot for it
+  size_t probe(const uint64_t key) const {
+    size_t mask = slots.size() - 1;
+    size_t slot = (size_t)splitMix64(key) & mask;
+    while (slots[slot]!=0 && entries[slots[slot]-1].first!=key) {
+      slot = (slot + 1) & mask;
+    }
+    return slot;
+  }
 
-  // the rnd generator
-  pcg32 rng;
+  void rehash(const size_t capacity) {
+    slots.assign(capacity, 0);
+    for (size_t i=0; i<entries.size(); ++i) {
+      slots[probe(entries[i].first)] = (uint32_t)(i + 1);
+    }
+  }
 
-  // galaxy data structure: holds sector data
-  std::map<uint64_t, UniverseSector> sectors;
+public:
+  size_t size() const { return entries.size(); }
+  bool empty() const { return entries.empty(); }
 
-  // galaxy data structure: holds system data
-  std::map<uint64_t, UniverseSystem> systems;
+  void clear() {
+    entries.clear();
+    slots.clear();
+  }
 
-  /**
-   * Class constructor
-  **/
-  ProcUGalaxy() {}
+  // room for count sectors without rehashing
+  void reserve(const size_t count) {
+    entries.reserve(count);
+    size_t capacity = 16;
+    while (capacity < 2*count) { capacity *= 2; }
+    if (capacity > slots.size()) { rehash(capacity); }
+  }
 
-  /**
-   * Class destructor
-  **/
-  ~ProcUGalaxy() {}
+  iterator begin() { return entries.begin(); }
+  iterator end() { return entries.end(); }
+  const_iterator begin() const { return entries.begin(); }
+  const_iterator end() const { return entries.end(); }
 
+  iterator find(const uint64_t key) {
+    if (slots.empty()) { return entries.end(); }
+    uint32_t index = slots[probe(key)];
+    return index==0 ? entries.end() : entries.begin() + (index - 1);
+  }
 
-  //---------------------------------
-  // create seeds
-  //---------------------------------
+  const_iterator find(const uint64_t key) const {
+    if (slots.empty()) { return entries.end(); }
+    uint32_t index = slots[probe(key)];
+    return index==0 ? entries.end() : entries.begin() + (index - 1);
+  }
 
-  /**
-   * @brief creates a random uint64_t seed from the
-   * system's random device.
-   * @param  none
-   * @return uint64_t seed
-   * @author pyramid
-  **/
-  uint64_t createGalaxySeed() {
-    // create pristine seed
-    //cout << "--- creating pristine random seed\n";
-    random_device rd;  // rom random device
-    galaxySeed = static_cast<uint64_t>(rd());
-    //cout << "  seed from random device: 0x" << setw(16) << setfill('0') << hex << uSeed
-    //  << dec << " (" << uSeed << ") ("<< sizeof(uSeed) << " bytes)\n";
-    // initialize random generator and retuen seed
-    rng.seed(galaxySeed);
-    return galaxySeed;
-  } // end function
+  size_t count(const uint64_t key) const {
+    return find(key)!=end() ? 1 : 0;
+  }
 
   /**
-   * @brief set and store new galaxy uint64_t seed
-   * @param  uint64_t seed
-   * @return none
-   * @author pyramid
-  **/
-  void setGalaxySeed(uint64_t seed) {
-    galaxySeed = seed;
-    rng.seed(galaxySeed);
-  } // end function
+   * @brief Returns the sector of a key, inserting a
+   * default constructed sector if there is none.
+   * Inserting invalidates iterators and references to
+   * other sectors (the dense array may reallocate),
+   * unlike std::map; looking up a stored key does not.
+   */
+  UniverseSector& operator[](const uint64_t key) {
+    if (!slots.empty()) {
+      uint32_t index = slots[probe(key)];
+      if (index!=0) { return entries[index-1].second; }
+    }
+    // keep the load factor at most 1/2
+    if (2*(entries.size() + 1) > slots.size()) {
+      rehash(max((size_t)16, 2*slots.size()));
+    }
+    size_t slot = probe(key);
+    entries.emplace_back(key, UniverseSector());
+    slots[slot] = (uint32_t)entries.size();
+    return entries.back().second;
+  }
 
   /**
-   * Returns seed for the sector specified by the sector
-   * coordinate in xyz.
-   * The galaxy seed needed for this function is obtained
-   * from the global variable galaxySeed.
+   * @brief Orders the sectors by key (Z-order).
+   * Invalidates iterators and references.
    */
-  uint64_t getSectorSeed(const int x, const int y, const int z) {
-    // here we modify the sector seed to be derived from the galaxy seed
-    // we must do the multiplication as signed integers
-    // to account for potential overflow
-    // and then convert back to unsigned integer to keep the seed,
-    // since seed cannot be negative
-    // clang-9 does not handle overflow
-    //uint64_t seedSector = (uint64_t)((int64_t)(galaxySeed) * ((int64_t)6e12 + (int64_t)x*(int64_t)1e9 + (int64_t)z*(int64_t)1e4 + (int64_t)y));
-    //uint64_t seedSector = (uint64_t)((int64_t)(galaxySeed) + ((int64_t)6e13 + (int64_t)x*(int64_t)1e9 + (int64_t)z*(int64_t)1e5 + (int64_t)y));
-    // clang-9 doesn't handle casting well
-    // so the following works better
-    uint64_t seedSector = galaxySeed + 6e14 + x*1e9 + z*1e5 + y;
+  void sortByKey() {
+    std::sort(entries.begin(), entries.end(),
+      [](const value_type &a, const value_type &b) { return a.first < b.first; });
+    rehash(slots.size());
+  }
 
-    //cout << "  galaxy seed input: " << hex << setw(16) << setfill('0') << hex << galaxySeed 
-    //  << dec << " ("<< galaxySeed << ") (" << dec << sizeof(galaxySeed) << " bytes)\n";
-    //cout << "  getSectorSeed:" << setfill(' ') << setw(3) << x << setw(3) << y << setw(3) << z << " : "
-    //  << hex << setw(16) << setfill('0') << hex << seedSector 
-    //  << dec << " ("<< seedSector << ") (" << dec << sizeof(seedSector) << " bytes)\n";
-    return seedSector;
-  } // end function
+}; // end class SectorTable
 
-  /**
-   * @brief Creates system seeds
-   * TODO: only create required number of seeds instead of MAX_SYSTEMS
-  **/
-  std::vector<uint64_t> getSystemSeeds(const uint64_t uSectorSeed) {
-    std::vector<uint64_t> vSystemSeeds;
-    for (int n=0; n<MAX_SYSTEMS; ++n) {
-      uint64_t uSeedSystem = (uint64_t)((int64_t)uSectorSeed + 123 + (int64_t)1e11*(int64_t)n);
-      vSystemSeeds.push_back(uSeedSystem);
-      //cout.precision(4);
-      //cout << "  " << n << " : "
-      //  << "0x" << hex << uSeedSystem << dec << " (" << uSeedSystem
-      //  << ") (" << sizeof(uSeedSystem)<< " bytes)\n";
-    }
 
-    return vSystemSeeds;
-  } // end function
+/**
+ * @brief Result of a spatial system query.
+ */
+struct SystemQueryResult {
+  // the system seed
+  uint64_t systemSeed = 0;
+  // the parent sector seed
+  uint64_t sectorSeed = 0;
+  // system position in galaxy coordinates in [ly]
+  std::vector<double> position = {0.0, 0.0, 0.0};
+  // distance from the query center in [ly]
+  // (zero for box queries)
+  double distance = 0.0;
+};
 
-  /**
-   * @brief Creates star seeds
-   * @param uint8_t howMany - How many stars there are in the system
-  **/
-  std::vector<uint64_t> getStarSeeds(const uint64_t uSystemSeed, uint8_t howMany) {
-    std::vector<uint64_t> vStarSeeds;
+/**
+ * Generation stages of a staged query (querySystems)
+**/
+enum QUERY_LEVEL {
+    QUERY_SYSTEM     = 0,
+    QUERY_STAR       = 1,
+    QUERY_PLANET     = 2,
+    QUERY_ATMOSPHERE = 3,
+    QUERY_LEVELS     = 4
+};
 
-    // generate star seeds
-    for (int n=0; n<howMany; ++n) {
-      uint64_t uSeedStar = (uint64_t)((int64_t)uSystemSeed + 1.876e8 + 1e4*(int64_t)n);
-      vStarSeeds.push_back(uSeedStar);
-    }
-    return vStarSeeds;
-  } // end function
+/**
+ * @brief Staged galaxy search (see querySystems).
+ * Each predicate is evaluated as soon as its level is
+ * generated; a rejected object's subtree is not generated.
+ * An empty predicate accepts all objects of its level.
+ * A system matches with at least one matching star; with
+ * a planet or atmosphere predicate a star matches with at
+ * least one matching planet, otherwise its planets are
+ * not generated.
+ */
+struct GalaxyQuery {
+  // search sphere in galaxy coordinates [ly],
+  // a negative radius searches the whole galaxy
+  std::vector<double> centerLy = {0.0, 0.0, 0.0};
+  double radiusLy = -1.0;
+  // position and multiplicity (genSystemData)
+  std::function<bool(const UniverseSystem&)> system;
+  // complete star without planets (genStar)
+  std::function<bool(const UniverseStar&)> star;
+  // planet without atmosphere (genPlanetBody)
+  std::function<bool(const UniversePlanet&)> planet;
+  // planet with atmosphere
+  std::function<bool(const UniversePlanet&)> atmosphere;
+};
 
-  /**
-   * @brief Creates planet seeds
-   * @param uint8_t howMany - How many planets there are for this star
-  **/
-  std::vector<uint64_t> getPlanetSeeds(const uint64_t uStarSeed, uint8_t howMany) {
-    std::vector<uint64_t> planetSeeds;
-    for (int n=0; n<howMany; ++n) {
-      uint64_t uSeedPlanet = (uint64_t)((int64_t)uStarSeed + 5432 + (int64_t)n*1e4 + n);
-      //uint64_t uSeedPlanet = (uint64_t)((int64_t)uStarSeed + n);
-      planetSeeds.push_back(uSeedPlanet);
-      //cout << uSeedPlanet << "\n";
-    }
-    return planetSeeds;
-  } // end function
+/**
+ * @brief Counters of a staged query per QUERY_LEVEL.
+ * QUERY_ATMOSPHERE counts atmosphere draws, one per planet
+ * (planets without an atmosphere get radius 0), except
+ * matched, which counts the result planets with one.
+ * Planets and atmospheres are only counted with a planet
+ * or atmosphere predicate, as they are not generated
+ * otherwise.
+ */
+struct GalaxyQueryStats {
+  // objects generated
+  size_t generated[QUERY_LEVELS] = {};
+  // objects rejected by their predicate
+  // (systems also outside the search sphere)
+  size_t rejected[QUERY_LEVELS] = {};
+  // objects not generated as an ancestor was rejected,
+  // the whole subtree (sizes from planetCountOf)
+  size_t pruned[QUERY_LEVELS] = {};
+  // objects in the query result
+  size_t matched[QUERY_LEVELS] = {};
+};
 
+/**
+ * @brief Result of a staged query: the system with
+ * its matching stars and their matching planets.
+ */
+struct SystemQueryMatch {
+  // seeds, position and distance
+  SystemQueryResult location;
+  // the system with the matching stars only
+  UniverseSystem system;
+};
 
-  //---------------------------------
-  // generate universe system data
-  //---------------------------------
 
-  UniverseSector genSector(const int x, const int y, const int z) {
-    // init system data container
-    UniverseSector sector = UniverseSector();
-    sector.seed = getSectorSeed(x,y,z);
-    sector.position = {(double)x, (double)y, (double)z};
-    return sector;
-  }
+//-----------------------------------
+// Columnar Universe Store
+//-----------------------------------
 
-  /**
-   * @brief Generates all sectors in galaxy
-   */
-  void genSectors() {
-    for (int x=-GALAXY_SIZE_LY[0]/SECTOR_SIZE_LY/2; x<GALAXY_SIZE_LY[0]/SECTOR_SIZE_LY/2; ++x) {
-      for (int z=-GALAXY_SIZE_LY[2]/SECTOR_SIZE_LY/2; z<GALAXY_SIZE_LY[2]/SECTOR_SIZE_LY/2; ++z) {
-        for (int y=-GALAXY_SIZE_LY[1]/SECTOR_SIZE_LY/2; y<GALAXY_SIZE_LY[1]/SECTOR_SIZE_LY/2; ++y) {
-            UniverseSector sector = genSector(x,y,z);
-            sectors[sector.seed] = sector;
-            //cout << setfill(' ') << setw(3) << x << setw(3) << y << setw(3) << z << " : "
-            //  << "0x" << setw(16) << setfill('0') << hex << sector.seed
-            //  << setw(3) << setfill(' ') << dec << " (" << sector.seed
-            //  << ") (" << sizeof(sector.seed)<< " bytes)\n";
-        } // y
-      } // z
-    } // x
-  } // end genSectors
+/**
+ * @brief Structure-of-arrays store for systems, stars and planets.
+ * Every generated field lives in its own contiguous column,
+ * so that batch passes over millions of objects stream
+ * linearly through memory instead of chasing map nodes.
+ * Children are referenced by offset ranges of their parent:
+ * the stars of system i are [systemStarOffset[i], systemStarOffset[i+1])
+ * and the planets of star j are [starPlanetOffset[j], starPlanetOffset[j+1]).
+ * Use the view types for object-like access and
+ * getSystem/getStar/getPlanet to materialize the structs.
+ */
+struct UniverseStore {
+
+  // number of atmosphere composition slots per planet
+  // (in AtmosphereGas order)
+  static const int COMPOSITION_SLOTS = GAS_COUNT;
 
   //---------------------------------
-  // generate universe system data
+  // system columns
   //---------------------------------
+  std::vector<uint64_t> systemSeed;
+  std::vector<uint64_t> systemSector;
+  // position within the sector in [ly]
+  std::vector<double> systemX, systemY, systemZ;
+  std::vector<uint8_t> systemMultiplicity;
+  // star index range, size systems + 1
+  std::vector<uint32_t> systemStarOffset = {0};
 
-  UniverseSystem genSystem(const uint64_t systemSeed) {
-    // init system data container
-    UniverseSystem system = UniverseSystem();
+  //---------------------------------
+  // star columns
+  //---------------------------------
+  std::vector<uint64_t> starSeed;
+  // parent system index
+  std::vector<uint32_t> starSystem;
+  std::vector<uint8_t> starTypeIndex;
+  std::vector<int8_t> starTemperatureSubclass;
+  std::vector<float> starMass;
+  std::vector<float> starLuminosity;
+  std::vector<float> starTemperature;
+  std::vector<float> starRadius;
+  // rgb color, 3 bytes per star
+  std::vector<byte> starColor;
+  // habitable zone limits, 8 floats per star
+  std::vector<float> starHzDistAu;
+  std::vector<float> starFrostLimitAu;
+  std::vector<float> starAxialRotation;
+  // planet index range, size stars + 1
+  std::vector<uint32_t> starPlanetOffset = {0};
 
-    // init generator
-    pcg32 rng(systemSeed);
+  //---------------------------------
+  // planet columns
+  //---------------------------------
+  std::vector<uint64_t> planetSeed;
+  // parent star index
+  std::vector<uint32_t> planetStar;
+  std::vector<float> planetStarDistance;
+  std::vector<uint8_t> planetIsInHz;
+  std::vector<int8_t> planetTypeIndex;
+  std::vector<float> planetMass;
+  std::vector<float> planetMu;
+  std::vector<float> planetTemperature;
+  std::vector<float> planetEquatorTemperature;
+  std::vector<float> planetPoleTemperature;
+  std::vector<float> planetRadius;
+  std::vector<float> planetDay;
+  std::vector<float> planetYear;
+  std::vector<float> planetProbTemp;
+  std::vector<float> planetProbGrav;
+  std::vector<float> planetProbAtmo;
+  std::vector<float> atmosphereRadius;
+  std::vector<float> atmospherePressure;
+  // composition volume parts, COMPOSITION_SLOTS per planet
+  std::vector<float> atmosphereComposition;
+  // bit i set if componentOrder[i] is part of the composition
+  std::vector<uint16_t> atmosphereElements;
 
-    // generate data
-    system.seed = systemSeed;
-    // generate random system position
-    system.position = {
-      rng.nextDouble() * SECTOR_SIZE_LY,
-      rng.nextDouble() * SECTOR_SIZE_LY,
-      rng.nextDouble() * SECTOR_SIZE_LY
-    };
-    // generate random system multiplicity
-    float rnum = rng.nextFloat();
-    //cout << "    rand number for getting system multiplicity: " << rnum << "\n";
-    system.multiplicity = getRndCdfIdx(rnum, starSystemMultiProbability) + 1;
-    //cout << "  number of stars in system: " << system.multiplicity << "\n";
 
-    // insert or update the system data in the galaxy model
-    systems[system.seed] = system;
+  //---------------------------------
+  // size
+  //---------------------------------
 
-    return system;
-  } // end function
+  size_t systemCount() const { return systemSeed.size(); }
+  size_t starCount() const { return starSeed.size(); }
+  size_t planetCount() const { return planetSeed.size(); }
 
   /**
-   * @brief Generates systems and adds them to sector
+   * @brief Removes all objects from the store.
    */
-  void genSystems(const uint64_t sectorSeed) {
-    // add seeds to sector
-    sectors[sectorSeed].systemSeeds = getSystemSeeds(sectorSeed);
+  void clear() {
+    *this = UniverseStore();
   }
 
 
   //---------------------------------
-  // generate universe star data
+  // append objects
   //---------------------------------
 
-  UniverseStar genStar(uint64_t starSeed) {
-    //cout << "  generating star "
-    //  << "0x" << setw(16) << setfill('0') << hex << starSeed << dec << " ("
-    //  << starSeed << ") (" << sizeof(starSeed) << " bytes)\n";
-
-    // init star data container
-    UniverseStar star = UniverseStar();
+  /**
+   * @brief Appends a system with its stars and planets.
+   * @return index of the system in the store
+   */
+  size_t append(const UniverseSystem &system) {
+    size_t systemIndex = systemSeed.size();
+    systemSeed.push_back(system.seed);
+    systemSector.push_back(system.sector);
+    systemX.push_back(system.position.size()>0 ? system.position[0] : 0.0);
+    systemY.push_back(system.position.size()>1 ? system.position[1] : 0.0);
+    systemZ.push_back(system.position.size()>2 ? system.position[2] : 0.0);
+    systemMultiplicity.push_back((uint8_t)system.multiplicity);
+    for (auto& [seed, star] : system.stars) {
+      appendStar(star, (uint32_t)systemIndex);
+    }
+    systemStarOffset.push_back((uint32_t)starSeed.size());
+    return systemIndex;
+  }
 
-    // set object seed
-    star.seed = starSeed;
-    rng.seed(starSeed);
-    
-    // get probability index from starTypeProbability
-    // density function
-    int idx = getRndCdfIdx(rng.nextFloat(), starTypeProbability);
-    star.typeIndex = (uint)idx;
 
-    // generate object data
+  //---------------------------------
+  // materialize objects
+  //---------------------------------
 
-    // star mass in [Msol]
-    float massMin = *(std::next(minMass.begin(), idx));
-    float massMax = *(std::next(maxMass.begin(), idx));
-    star.mass = massMin + rng.nextFloat()*(massMax-massMin);
+  /**
+   * @brief Returns the planet at index as struct.
+   */
+  UniversePlanet getPlanet(size_t i) const {
+    UniversePlanet planet = UniversePlanet();
+    planet.seed = planetSeed[i];
+    planet.position = {planetStarDistance[i], 0, 0};
+    planet.starDistance = planetStarDistance[i];
+    planet.isInHz = planetIsInHz[i];
+    planet.typeIndex = planetTypeIndex[i];
+    planet.mass = planetMass[i];
+    planet.mu = planetMu[i];
+    planet.temperature = planetTemperature[i];
+    planet.equatorTemperature = planetEquatorTemperature[i];
+    planet.poleTemperature = planetPoleTemperature[i];
+    planet.radius = planetRadius[i];
+    planet.day = planetDay[i];
+    planet.year = planetYear[i];
+    planet.probTemp = planetProbTemp[i];
+    planet.probGrav = planetProbGrav[i];
+    planet.probAtmo = planetProbAtmo[i];
+    planet.atmosphere.radius = atmosphereRadius[i];
+    planet.atmosphere.pressure = atmospherePressure[i];
+    for (int e=0; e<COMPOSITION_SLOTS; ++e) {
+      planet.atmosphere.composition.parts[e] = atmosphereComposition[i*COMPOSITION_SLOTS+e];
+    }
+    planet.atmosphere.composition.elements = atmosphereElements[i];
+    return planet;
+  }
 
-    // star radius in [Rsol]
-    float radiusMin = *(std::next(minRadius.begin(), idx));
-    float radiusMax = *(std::next(maxRadius.begin(), idx));
-    star.radius = radiusMin + rng.nextFloat()*(radiusMax-radiusMin);
+  /**
+   * @brief Returns the star at index with its planets as struct.
+   */
+  UniverseStar getStar(size_t i) const {
+    UniverseStar star = UniverseStar();
+    star.seed = starSeed[i];
+    star.typeIndex = starTypeIndex[i];
+    star.mass = starMass[i];
+    star.luminosity = starLuminosity[i];
+    star.temperature = starTemperature[i];
+    star.radius = starRadius[i];
+    star.color = {starColor[3*i], starColor[3*i+1], starColor[3*i+2]};
+    for (int h=0; h<8; ++h) {
+      star.hzDistAu[h] = starHzDistAu[8*i+h];
+    }
+    star.frostLimitAu = starFrostLimitAu[i];
+    star.axialRotation = starAxialRotation[i];
+    star.temperatureSubclass = starTemperatureSubclass[i];
+    star.planetsCount = starPlanetOffset[i+1] - starPlanetOffset[i];
+    for (uint32_t p=starPlanetOffset[i]; p<starPlanetOffset[i+1]; ++p) {
+      star.planets[planetSeed[p]] = getPlanet(p);
+    }
+    return star;
+  }
 
-    // luminosity in [Lsol]
-    // we abandon random luminosity in favor of modeled luminosity
-    //float luminosityMin = *(std::next(minLuminosity.begin(), idx));
-    //float luminosityMax = *(std::next(maxLuminosity.begin(), idx));
-    //star.luminosity = luminosityMin + rng.nextFloat()*(luminosityMax - luminosityMin);
-    star.luminosity = calcLuminosity(star.mass);
+  /**
+   * @brief Returns the system at index with its stars
+   * and planets as struct.
+   */
+  UniverseSystem getSystem(size_t i) const {
+    UniverseSystem system = UniverseSystem();
+    system.seed = systemSeed[i];
+    system.sector = systemSector[i];
+    system.position = {systemX[i], systemY[i], systemZ[i]};
+    system.multiplicity = systemMultiplicity[i];
+    for (uint32_t s=systemStarOffset[i]; s<systemStarOffset[i+1]; ++s) {
+      system.stars[starSeed[s]] = getStar(s);
+    }
+    return system;
+  }
 
-    // photosphere temperature in Kelvin [K]
-    float temperatureMin = *(std::next(minTemperature.begin(), idx));
-    float temperatureMax = *(std::next(maxTemperature.begin(), idx));
-    star.temperature = temperatureMin + rng.nextFloat()*(temperatureMax - temperatureMin);
+private:
 
-    // stellar classification (needs temperature)
-    star.spectralClass = *(std::next(spectralClass.begin(), idx));
-    star.luminosityClass = *(std::next(luminosityClass.begin(), idx));
-    star.temperatureSequence = genStarTemperatureSequence(idx, star.temperature);
-    star.stellarType = star.spectralClass + star.temperatureSequence + star.luminosityClass;
-    star.designation = *(std::next(starDesignation.begin(), idx));
+  void appendStar(const UniverseStar &star, uint32_t systemIndex) {
+    size_t starIndex = starSeed.size();
+    starSeed.push_back(star.seed);
+    starSystem.push_back(systemIndex);
+    starTypeIndex.push_back((uint8_t)star.typeIndex);
+    starTemperatureSubclass.push_back(star.temperatureSubclass);
+    starMass.push_back(star.mass);
+    starLuminosity.push_back(star.luminosity);
+    starTemperature.push_back(star.temperature);
+    starRadius.push_back(star.radius);
+    for (int c=0; c<3; ++c) {
+      starColor.push_back(star.color[c]);
+    }
+    for (int h=0; h<8; ++h) {
+      starHzDistAu.push_back(star.hzDistAu[h]);
+    }
+    starFrostLimitAu.push_back(star.frostLimitAu);
+    starAxialRotation.push_back(star.axialRotation);
+    for (auto& [seed, planet] : star.planets) {
+      appendPlanet(planet, (uint32_t)starIndex);
+    }
+    starPlanetOffset.push_back((uint32_t)planetSeed.size());
+  }
 
-    // determine star color
-    star.color = getStarColor(star.temperature);
+  void appendPlanet(const UniversePlanet &planet, uint32_t starIndex) {
+    planetSeed.push_back(planet.seed);
+    planetStar.push_back(starIndex);
+    planetStarDistance.push_back(planet.starDistance);
+    planetIsInHz.push_back(planet.isInHz);
+    planetTypeIndex.push_back((int8_t)planet.typeIndex);
+    planetMass.push_back(planet.mass);
+    planetMu.push_back(planet.mu);
+    planetTemperature.push_back(planet.temperature);
+    planetEquatorTemperature.push_back(planet.equatorTemperature);
+    planetPoleTemperature.push_back(planet.poleTemperature);
+    planetRadius.push_back(planet.radius);
+    planetDay.push_back(planet.day);
+    planetYear.push_back(planet.year);
+    planetProbTemp.push_back(planet.probTemp);
+    planetProbGrav.push_back(planet.probGrav);
+    planetProbAtmo.push_back(planet.probAtmo);
+    atmosphereRadius.push_back(planet.atmosphere.radius);
+    atmospherePressure.push_back(planet.atmosphere.pressure);
+    for (int e=0; e<COMPOSITION_SLOTS; ++e) {
+      atmosphereComposition.push_back(planet.atmosphere.composition.parts[e]);
+    }
+    atmosphereElements.push_back(planet.atmosphere.composition.elements);
+  }
 
-    // generate specific per star habitable zone
-    // i = 1 --> Recent Venus !!! (inner HZ limit)
-    // i = 5 --> Early Mars !!! (outer HZ limit)
-    // for all limits, see comments of the function
-    habitableZoneComplete(star.hzDistAu, star.temperature, star.luminosity);
-    //for(int i=0; i<8; ++i) {
-    //  cout << "hzDistAu[" << i << "] = " << star.hzDistAu[i] << "\n";
-    //}
+}; // end struct UniverseStore
 
-    // calculate frost limit
-    star.frostLimitAu = calcFrostLimit(star.luminosity);
 
-    // axial rotation approximation from star radius and mass
-    // = pi * radius [Rsol] * RSol [km] / mass [Msol]
-    star.axialRotation = M_PI * star.radius * Rsol / star.mass;
+/**
+ * @brief View of a planet in a UniverseStore.
+ * Reads the columns in place without copying.
+ */
+struct UniversePlanetView {
+  const UniverseStore *store;
+  size_t index;
+
+  uint64_t seed() const { return store->planetSeed[index]; }
+  float starDistance() const { return store->planetStarDistance[index]; }
+  bool isInHz() const { return store->planetIsInHz[index]; }
+  int typeIndex() const { return store->planetTypeIndex[index]; }
+  float mass() const { return store->planetMass[index]; }
+  float temperature() const { return store->planetTemperature[index]; }
+  float radius() const { return store->planetRadius[index]; }
+  bool hasAtmosphere() const { return store->atmosphereRadius[index]>0; }
+  size_t starIndex() const { return store->planetStar[index]; }
+  UniversePlanet get() const { return store->getPlanet(index); }
+};
 
-    // how many planets will this star host?
-    // we determine (unscientifically)
-    // that a star may have between zero
-    // and eight planets
-    star.planetsCount = rng.nextUInt(8);
-    //cout << "   (debug) plnets count : " << star.planetsCount << endl;
+/**
+ * @brief View of a star in a UniverseStore.
+ */
+struct UniverseStarView {
+  const UniverseStore *store;
+  size_t index;
+
+  uint64_t seed() const { return store->starSeed[index]; }
+  uint typeIndex() const { return store->starTypeIndex[index]; }
+  int temperatureSubclass() const { return store->starTemperatureSubclass[index]; }
+  float mass() const { return store->starMass[index]; }
+  float luminosity() const { return store->starLuminosity[index]; }
+  float temperature() const { return store->starTemperature[index]; }
+  float radius() const { return store->starRadius[index]; }
+  float hzDistAu(int i) const { return store->starHzDistAu[8*index+i]; }
+  float frostLimitAu() const { return store->starFrostLimitAu[index]; }
+  size_t systemIndex() const { return store->starSystem[index]; }
+  // planet index range
+  size_t planetBegin() const { return store->starPlanetOffset[index]; }
+  size_t planetEnd() const { return store->starPlanetOffset[index+1]; }
+  size_t planetsCount() const { return planetEnd() - planetBegin(); }
+  UniversePlanetView planet(size_t i) const { return {store, planetBegin()+i}; }
+  UniverseStar get() const { return store->getStar(index); }
+};
 
-    return star;
+/**
+ * @brief View of a system in a UniverseStore.
+ */
+struct UniverseSystemView {
+  const UniverseStore *store;
+  size_t index;
+
+  uint64_t seed() const { return store->systemSeed[index]; }
+  uint64_t sector() const { return store->systemSector[index]; }
+  std::vector<double> position() const {
+    return {store->systemX[index], store->systemY[index], store->systemZ[index]};
   }
+  int multiplicity() const { return store->systemMultiplicity[index]; }
+  // star index range
+  size_t starBegin() const { return store->systemStarOffset[index]; }
+  size_t starEnd() const { return store->systemStarOffset[index+1]; }
+  UniverseStarView star(size_t i) const { return {store, starBegin()+i}; }
+  UniverseSystem get() const { return store->getSystem(index); }
+};
 
-  void genStars(uint64_t systemSeed) {
-    //cout << "  genStars\n";
-    // get star seeds for this system
-    vector<uint64_t> starSeeds = getStarSeeds(systemSeed, systems[systemSeed].multiplicity);
 
-    // generate a random number of stars
-    for(int i=0; i<systems[systemSeed].multiplicity; ++i) {
-      //cout << "  starting star id " << i << "\n";
-      // create at least one star
-      //cout << "  star " << i+1 << "\n";
-      UniverseStar star = genStar(starSeeds[i]);
-      systems[systemSeed].stars[starSeeds[i]] = star;
-    }
-    //cout << "  generated " << systems[systemSeed].multiplicity << " star"
-    //  << (systems[systemSeed].multiplicity==1? "":"s") <<".\n";
+//-----------------------------------
+// UniverseStore batch passes
+//-----------------------------------
 
-    // TODO: generate orbitals for all stars
+/**
+ * @brief Scores all planets of a store with planetHabitabilityBatch.
+ * Updates the planetTemperature, planetProbTemp and planetProbGrav
+ * columns, and fills relative gravity and habitability
+ * (as getPlanetHabitability) per planet.
+ * @param store - store holding the planets
+ * @param grel - relative surface gravity in [g] per planet
+ * @param score - habitability per planet
+ * @param limits - physiological limits
+ */
+void scorePlanets(UniverseStore &store, std::vector<float> &grel,
+    std::vector<float> &score, const HabitabilityLimits &limits = HabitabilityLimits()) {
+  size_t count = store.planetCount();
+  // host star luminosity and location factor per planet
+  std::vector<float> starLuminosity(count);
+  std::vector<float> factor(count);
+  for (size_t i=0; i<count; ++i) {
+    starLuminosity[i] = store.starLuminosity[store.planetStar[i]];
+    float atmosphere = 1.0f;
+    if (store.atmosphereRadius[i]>0) {
+      AtmosphereComposition composition;
+      std::copy_n(&store.atmosphereComposition[i*UniverseStore::COMPOSITION_SLOTS],
+        UniverseStore::COMPOSITION_SLOTS, composition.parts);
+      composition.elements = store.atmosphereElements[i];
+      atmosphere = atmosphereHabitability(composition);
+    }
+    factor[i] = store.planetIsInHz[i] ? atmosphere : 0.0f;
+  }
+  grel.resize(count);
+  score.resize(count);
+  planetHabitabilityBatch(starLuminosity.data(), store.planetStarDistance.data(),
+    store.planetMass.data(), store.planetRadius.data(), factor.data(),
+    store.planetTemperature.data(), grel.data(), store.planetProbTemp.data(),
+    store.planetProbGrav.data(), score.data(), count, limits);
+}
 
-  } // end function
 
+//-----------------------------------
+// libProcU procu::ProcUGalaxy enum
+//-----------------------------------
 
-  //---------------------------------
-  // generate universe planet data
-  //---------------------------------
+/**
+ * Galaxy Types that can be generated
+**/
+enum GALAXY_TYPE {
+    SPIRAL   = 0,
+    GLOBULAR = 1
+};
 
-  /**
-   * Generate a planet for a parent star
-   * @param planetSeed - seed for generating further data
-   * @param star - parent star mass is required for planet
-   *   mas density calculaiton
-   * @param planetDistanceAu - planet distanc from the
-   *   parent star
-   * @param lowerLimitAu - start of the mass accretion
-   *   distance from parent star
-   * @return planet - UniversePlanet object
-   */
-  UniversePlanet genPlanet(uint64_t planetSeed, UniverseStar &star, float planetDistanceAu, float &lowerLimitAu) {
-    //cout << "generating planet : "
-    //  << "0x" << setw(16) << setfill('0') << hex << planetSeed << dec << " ("
-    //  << planetSeed << ") (" << sizeof(planetSeed) << " bytes)\n";
+/**
+ * Seed derivation schemes for sectors, systems, stars and planets
+**/
+enum SEED_SCHEME {
+    SEED_LEGACY = 0,  // fixed offsets added to the parent seed
+    SEED_HASHED = 1   // hashSeed of parent seed, level and index
+};
 
-    // init planet data container
-    UniversePlanet planet = UniversePlanet();
+/**
+ * Hierarchy levels for hashSeed
+**/
+enum SEED_LEVEL {
+    LEVEL_SECTOR = 1,
+    LEVEL_SYSTEM = 2,
+    LEVEL_STAR   = 3,
+    LEVEL_PLANET = 4
+};
 
-    // set object seed
-    planet.seed = planetSeed;
-    rng.seed(planetSeed);
+/**
+ * Generated attributes with their own random stream
+ * pcg32(object seed, attribute) when ATTRIBUTE_STREAMS is set.
+ * Stream 1 is the default pcg32 stream of the sequential
+ * generation, so attribute streams start at 2.
+**/
+enum GEN_ATTRIBUTE {
+    ATTR_SYSTEM_POSITION     = 2,
+    ATTR_SYSTEM_MULTIPLICITY = 3,
+    ATTR_STAR_TYPE           = 4,
+    ATTR_STAR_MASS           = 5,
+    ATTR_STAR_RADIUS         = 6,
+    ATTR_STAR_TEMPERATURE    = 7,
+    ATTR_STAR_PLANETS        = 8
+};
 
-    /// generate planet object data
 
-    // generate position
-    planet.position = {planetDistanceAu, 0, 0};
-    planet.starDistance = planetDistanceAu;
-    if ( (planet.starDistance>star.hzDistAu[1]) & (planet.starDistance<star.hzDistAu[5]) ) {
-      planet.isInHz = true;
-    }
+//-----------------------------------
+// libProcU procu::ProcUGalaxy class
+//-----------------------------------
+
+/**
+ * @brief ProcUGalaxy\n
+ * A galaxy procedural generator.
+ * See documentation at the top of this library file.
+ * 
+ * @author pyramid
+**/
+
+class ProcUGalaxy {
+
+private:
+
+public:
+  /// configuration variables
+  // galaxy size x, y, z
+  int GALAXY_TYPE = GALAXY_TYPE::SPIRAL;
+  std::vector<double> GALAXY_SIZE_LY{1.0e4, 100.0, 1.0e4};
+  double SECTOR_SIZE_LY = 10.0;
+  int MAX_SYSTEMS = 10;  // per sector
+  int MAX_STARS = 3;     // per system
+  int MAX_PLANETS = 10;  // per system
+  // generator threads for genGalaxyParallel
+  // (0 = use all hardware threads)
+  unsigned int THREADS = 0;
+  // star color from the StarColorTable lookup table
+  // instead of the analytic fit
+  bool STAR_COLOR_TABLE = false;
+  // star luminosity and planet mass density with the
+  // approximate math functions (fastExp, fastLog, fastPow)
+  bool FAST_MATH = false;
+  // draw each system and star attribute from its own stream
+  // (see GEN_ATTRIBUTE), so that starTypeOf, planetCountOf, ...
+  // need not generate the whole object; changes the generated
+  // galaxy, the default keeps the sequential draws
+  bool ATTRIBUTE_STREAMS = false;
+  // seed derivation (see SEED_SCHEME); SEED_HASHED avoids
+  // the overlapping legacy seeds of large galaxies but
+  // changes the generated galaxy
+  int SEED_SCHEME = SEED_SCHEME::SEED_LEGACY;
+
+  // the galaxy seed is global
+  uint64_t galaxySeed;
+
+  // the rnd generator
+  pcg32 rng;
+
+  // galaxy data structure: holds sector data
+  // keyed by sectorKey(x,y,z)
+  SectorTable sectors;
+
+  // galaxy data structure: holds system data
+  std::map<uint64_t, UniverseSystem> systems;
+
+  /**
+   * Class constructor
+  **/
+  ProcUGalaxy() {}
+
+  /**
+   * Class destructor
+  **/
+  ~ProcUGalaxy() {}
+
+
+  //---------------------------------
+  // create seeds
+  //---------------------------------
+
+  /**
+   * @brief creates a random uint64_t seed from the
+   * system's random device.
+   * @param  none
+   * @return uint64_t seed
+   * @author pyramid
+  **/
+  uint64_t createGalaxySeed() {
+    // create pristine seed
+    //cout << "--- creating pristine random seed\n";
+    random_device rd;  // rom random device
+    galaxySeed = static_cast<uint64_t>(rd());
+    //cout << "  seed from random device: 0x" << setw(16) << setfill('0') << hex << uSeed
+    //  << dec << " (" << uSeed << ") ("<< sizeof(uSeed) << " bytes)\n";
+    // initialize random generator and retuen seed
+    rng.seed(galaxySeed);
+    return galaxySeed;
+  } // end function
+
+  /**
+   * @brief set and store new galaxy uint64_t seed
+   * @param  uint64_t seed
+   * @return none
+   * @author pyramid
+  **/
+  void setGalaxySeed(uint64_t seed) {
+    galaxySeed = seed;
+    rng.seed(galaxySeed);
+  } // end function
+
+  /**
+   * Returns seed for the sector specified by the sector
+   * coordinate in xyz.
+   * The galaxy seed needed for this function is obtained
+   * from the global variable galaxySeed.
+   */
+  uint64_t getSectorSeed(const int x, const int y, const int z) const {
+    // here we modify the sector seed to be derived from the galaxy seed
+    // we must do the multiplication as signed integers
+    // to account for potential overflow
+    // and then convert back to unsigned integer to keep the seed,
+    // since seed cannot be negative
+    // clang-9 does not handle overflow
+    //uint64_t seedSector = (uint64_t)((int64_t)(galaxySeed) * ((int64_t)6e12 + (int64_t)x*(int64_t)1e9 + (int64_t)z*(int64_t)1e4 + (int64_t)y));
+    //uint64_t seedSector = (uint64_t)((int64_t)(galaxySeed) + ((int64_t)6e13 + (int64_t)x*(int64_t)1e9 + (int64_t)z*(int64_t)1e5 + (int64_t)y));
+    // clang-9 doesn't handle casting well
+    // so the following works better
+    uint64_t seedSector = galaxySeed + 6e14 + x*1e9 + z*1e5 + y;
+    if (SEED_SCHEME==SEED_HASHED) {
+      seedSector = hashSeed(galaxySeed, LEVEL_SECTOR, sectorKey(x,y,z));
+    }
+
+    //cout << "  galaxy seed input: " << hex << setw(16) << setfill('0') << hex << galaxySeed 
+    //  << dec << " ("<< galaxySeed << ") (" << dec << sizeof(galaxySeed) << " bytes)\n";
+    //cout << "  getSectorSeed:" << setfill(' ') << setw(3) << x << setw(3) << y << setw(3) << z << " : "
+    //  << hex << setw(16) << setfill('0') << hex << seedSector 
+    //  << dec << " ("<< seedSector << ") (" << dec << sizeof(seedSector) << " bytes)\n";
+    return seedSector;
+  } // end function
+
+  /**
+   * @brief Creates system seeds
+   * TODO: only create required number of seeds instead of MAX_SYSTEMS
+  **/
+  std::vector<uint64_t> getSystemSeeds(const uint64_t uSectorSeed) const {
+    std::vector<uint64_t> vSystemSeeds;
+    for (int n=0; n<MAX_SYSTEMS; ++n) {
+      uint64_t uSeedSystem = (uint64_t)((int64_t)uSectorSeed + 123 + (int64_t)1e11*(int64_t)n);
+      if (SEED_SCHEME==SEED_HASHED) {
+        uSeedSystem = hashSeed(uSectorSeed, LEVEL_SYSTEM, n);
+      }
+      vSystemSeeds.push_back(uSeedSystem);
+      //cout.precision(4);
+      //cout << "  " << n << " : "
+      //  << "0x" << hex << uSeedSystem << dec << " (" << uSeedSystem
+      //  << ") (" << sizeof(uSeedSystem)<< " bytes)\n";
+    }
+
+    return vSystemSeeds;
+  } // end function
+
+  /**
+   * @brief Creates star seeds
+   * @param uint8_t howMany - How many stars there are in the system
+  **/
+  std::vector<uint64_t> getStarSeeds(const uint64_t uSystemSeed, uint8_t howMany) const {
+    std::vector<uint64_t> vStarSeeds;
+
+    // generate star seeds
+    for (int n=0; n<howMany; ++n) {
+      uint64_t uSeedStar = (uint64_t)((int64_t)uSystemSeed + 1.876e8 + 1e4*(int64_t)n);
+      if (SEED_SCHEME==SEED_HASHED) {
+        uSeedStar = hashSeed(uSystemSeed, LEVEL_STAR, n);
+      }
+      vStarSeeds.push_back(uSeedStar);
+    }
+    return vStarSeeds;
+  } // end function
+
+  /**
+   * @brief Creates planet seeds
+   * @param uint8_t howMany - How many planets there are for this star
+  **/
+  std::vector<uint64_t> getPlanetSeeds(const uint64_t uStarSeed, uint8_t howMany) const {
+    std::vector<uint64_t> planetSeeds;
+    for (int n=0; n<howMany; ++n) {
+      uint64_t uSeedPlanet = (uint64_t)((int64_t)uStarSeed + 5432 + (int64_t)n*1e4 + n);
+      if (SEED_SCHEME==SEED_HASHED) {
+        uSeedPlanet = hashSeed(uStarSeed, LEVEL_PLANET, n);
+      }
+      //uint64_t uSeedPlanet = (uint64_t)((int64_t)uStarSeed + n);
+      planetSeeds.push_back(uSeedPlanet);
+      //cout << uSeedPlanet << "\n";
+    }
+    return planetSeeds;
+  } // end function
+
+
+  //---------------------------------
+  // sector cursor
+  //---------------------------------
+
+  /**
+   * @brief Iterator walking the sector coordinates of a region
+   * in genSectors order (x, then z, then y innermost).
+   * Seeds are derived on the fly when dereferencing,
+   * no sector objects are created.
+   */
+  class SectorCursor {
+  public:
+    SectorCursor(const ProcUGalaxy *galaxy, const SectorRegion &region, bool atEnd)
+      : galaxy(galaxy), region(region),
+        x(region.xMin), y(region.yMin), z(region.zMin) {
+      if (atEnd | region.empty()) { x = region.xMax; y = region.yMin; z = region.zMin; }
+    }
+
+    SectorCoordinate operator*() const {
+      SectorCoordinate coordinate;
+      coordinate.x = x;
+      coordinate.y = y;
+      coordinate.z = z;
+      coordinate.seed = galaxy->getSectorSeed(x,y,z);
+      return coordinate;
+    }
+
+    SectorCursor& operator++() {
+      if (++y < region.yMax) { return *this; }
+      y = region.yMin;
+      if (++z < region.zMax) { return *this; }
+      z = region.zMin;
+      ++x;
+      return *this;
+    }
+
+    bool operator==(const SectorCursor &other) const {
+      return (x==other.x) & (y==other.y) & (z==other.z);
+    }
+
+    bool operator!=(const SectorCursor &other) const {
+      return !(*this==other);
+    }
+
+  private:
+    const ProcUGalaxy *galaxy;
+    SectorRegion region;
+    int x, y, z;
+  }; // end class SectorCursor
+
+  /**
+   * @brief Range of sector coordinates for range based for loops.
+   * @code for (SectorCoordinate sector : galaxy.sectorRange()) {...} @endcode
+   */
+  class SectorRange {
+  public:
+    SectorRange(const ProcUGalaxy *galaxy, const SectorRegion &region)
+      : galaxy(galaxy), region(region) {}
+    SectorCursor begin() const { return SectorCursor(galaxy, region, false); }
+    SectorCursor end() const { return SectorCursor(galaxy, region, true); }
+    uint64_t size() const { return region.size(); }
+  private:
+    const ProcUGalaxy *galaxy;
+    SectorRegion region;
+  }; // end class SectorRange
+
+  /**
+   * @brief Returns the sector coordinate bounds of the galaxy
+   * as generated by genSectors.
+   */
+  SectorRegion getSectorBounds() const {
+    double extension[3];
+    for (int i=0; i<3; ++i) {
+      extension[i] = GALAXY_SIZE_LY[i]/SECTOR_SIZE_LY/2;
+    }
+    // integer coordinates below the (possibly fractional) extension
+    SectorRegion bounds;
+    bounds.xMin = (int)(-extension[0]);
+    bounds.yMin = (int)(-extension[1]);
+    bounds.zMin = (int)(-extension[2]);
+    bounds.xMax = (int)ceil(extension[0]);
+    bounds.yMax = (int)ceil(extension[1]);
+    bounds.zMax = (int)ceil(extension[2]);
+    return bounds;
+  }
+
+  /**
+   * @brief Lazy range over all sectors of the galaxy.
+   * Walks the same sectors in the same order as genSectors
+   * but in constant memory.
+   */
+  SectorRange sectorRange() const {
+    return SectorRange(this, getSectorBounds());
+  }
+
+  /**
+   * @brief Lazy range over the sectors of a region,
+   * clipped to the galaxy bounds.
+   * @param region - box in sector coordinates
+   */
+  SectorRange sectorRange(const SectorRegion &region) const {
+    return SectorRange(this, region.intersect(getSectorBounds()));
+  }
+
+
+  //---------------------------------
+  // generate universe system data
+  //---------------------------------
+
+  UniverseSector genSector(const int x, const int y, const int z) {
+    // init system data container
+    UniverseSector sector = UniverseSector();
+    sector.seed = getSectorSeed(x,y,z);
+    sector.position = {(double)x, (double)y, (double)z};
+    return sector;
+  }
+
+  /**
+   * @brief Generates all sectors in galaxy, stored in Z-order
+   */
+  void genSectors() {
+    sectors.reserve(sectors.size() + getSectorBounds().size());
+    for (SectorCoordinate coordinate : sectorRange()) {
+      UniverseSector sector = genSector(coordinate.x, coordinate.y, coordinate.z);
+      sectors[sectorKey(coordinate.x, coordinate.y, coordinate.z)] = sector;
+      //cout << setfill(' ') << setw(3) << x << setw(3) << y << setw(3) << z << " : "
+      //  << "0x" << setw(16) << setfill('0') << hex << sector.seed
+      //  << setw(3) << setfill(' ') << dec << " (" << sector.seed
+      //  << ") (" << sizeof(sector.seed)<< " bytes)\n";
+    }
+    sectors.sortByKey();
+  } // end genSectors
+
+  //---------------------------------
+  // generate universe system data
+  //---------------------------------
+
+  UniverseSystem genSystem(const uint64_t systemSeed) {
+    UniverseSystem system = genSystemData(systemSeed);
+
+    // insert or update the system data in the galaxy model
+    systems[system.seed] = system;
+
+    return system;
+  } // end function
+
+  /**
+   * @brief Generates system position and multiplicity
+   * without storing the system in the galaxy model.
+   */
+  UniverseSystem genSystemData(const uint64_t systemSeed) const {
+    // init system data container
+    UniverseSystem system = UniverseSystem();
+
+    // init generator
+    pcg32 rng(systemSeed);
+
+    // generate data
+    system.seed = systemSeed;
+    // generate random system position
+    attributeStream(rng, systemSeed, ATTR_SYSTEM_POSITION);
+    system.position = {
+      rng.nextDouble() * SECTOR_SIZE_LY,
+      rng.nextDouble() * SECTOR_SIZE_LY,
+      rng.nextDouble() * SECTOR_SIZE_LY
+    };
+    // generate random system multiplicity
+    float rnum = attributeStream(rng, systemSeed, ATTR_SYSTEM_MULTIPLICITY).nextFloat();
+    //cout << "    rand number for getting system multiplicity: " << rnum << "\n";
+    system.multiplicity = starSystemMultiSampler.sample(rnum) + 1;
+    //cout << "  number of stars in system: " << system.multiplicity << "\n";
+
+    return system;
+  } // end function
+
+  /**
+   * @brief Generates systems and adds them to sector
+   * (formerly genSystems taking the sector seed)
+   * @param key - sector key in sectors (see sectorKey),
+   *   the sector is generated if it is not stored yet
+   */
+  void genSystemsAt(const uint64_t key) {
+    if (sectors.count(key)==0) {
+      SectorCoordinate coordinate = sectorCoordinate(key);
+      sectors[key] = genSector(coordinate.x, coordinate.y, coordinate.z);
+    }
+    // add seeds to sector
+    UniverseSector &sector = sectors[key];
+    sector.systemSeeds = getSystemSeeds(sector.seed);
+  }
+
+
+  //---------------------------------
+  // generate universe star data
+  //---------------------------------
+
+  UniverseStar genStar(uint64_t starSeed) const {
+    //cout << "  generating star "
+    //  << "0x" << setw(16) << setfill('0') << hex << starSeed << dec << " ("
+    //  << starSeed << ") (" << sizeof(starSeed) << " bytes)\n";
+
+    // init star data container
+    UniverseStar star = UniverseStar();
+
+    // set object seed
+    // local generator, so that stars can be generated concurrently
+    star.seed = starSeed;
+    pcg32 rng(starSeed);
+
+    // get probability index from starTypeProbability
+    // density function
+    int idx = starTypeSampler.sample(attributeStream(rng, starSeed, ATTR_STAR_TYPE).nextFloat());
+    star.typeIndex = (uint)idx;
+
+    // generate object data
+
+    // star mass in [Msol]
+    float massMin = minMass[idx];
+    float massMax = maxMass[idx];
+    star.mass = massMin + attributeStream(rng, starSeed, ATTR_STAR_MASS).nextFloat()*(massMax-massMin);
+
+    // star radius in [Rsol]
+    float radiusMin = minRadius[idx];
+    float radiusMax = maxRadius[idx];
+    star.radius = radiusMin + attributeStream(rng, starSeed, ATTR_STAR_RADIUS).nextFloat()*(radiusMax-radiusMin);
+
+    // luminosity in [Lsol]
+    // we abandon random luminosity in favor of modeled luminosity
+    //float luminosityMin = minLuminosity[idx];
+    //float luminosityMax = maxLuminosity[idx];
+    //star.luminosity = luminosityMin + rng.nextFloat()*(luminosityMax - luminosityMin);
+    star.luminosity = calcLuminosity(star.mass, FAST_MATH);
+
+    // photosphere temperature in Kelvin [K]
+    float temperatureMin = minTemperature[idx];
+    float temperatureMax = maxTemperature[idx];
+    star.temperature = temperatureMin + attributeStream(rng, starSeed, ATTR_STAR_TEMPERATURE).nextFloat()*(temperatureMax - temperatureMin);
+
+    // stellar classification (needs temperature)
+    classifyStar(star);
+
+    // determine star color
+    star.color = STAR_COLOR_TABLE ? getStarColorTabled(star.temperature) : getStarColor(star.temperature);
+
+    // generate specific per star habitable zone
+    // i = 1 --> Recent Venus !!! (inner HZ limit)
+    // i = 5 --> Early Mars !!! (outer HZ limit)
+    // for all limits, see comments of the function
+    habitableZoneComplete(star.hzDistAu, star.temperature, star.luminosity);
+    //for(int i=0; i<8; ++i) {
+    //  cout << "hzDistAu[" << i << "] = " << star.hzDistAu[i] << "\n";
+    //}
+
+    // calculate frost limit
+    star.frostLimitAu = calcFrostLimit(star.luminosity);
+
+    // axial rotation approximation from star radius and mass
+    // = pi * radius [Rsol] * RSol [km] / mass [Msol]
+    star.axialRotation = M_PI * star.radius * Rsol / star.mass;
+
+    // how many planets will this star host?
+    // we determine (unscientifically)
+    // that a star may have between zero
+    // and eight planets
+    star.planetsCount = attributeStream(rng, starSeed, ATTR_STAR_PLANETS).nextUInt(8);
+    //cout << "   (debug) plnets count : " << star.planetsCount << endl;
+
+    return star;
+  }
+
+  void genStars(uint64_t systemSeed) {
+    //cout << "  genStars\n";
+    genStars(systems[systemSeed]);
+  } // end function
+
+  /**
+   * @brief Generates the stars of a system object
+   * which need not be stored in the galaxy model.
+   */
+  void genStars(UniverseSystem &system) const {
+    // get star seeds for this system
+    vector<uint64_t> starSeeds = getStarSeeds(system.seed, system.multiplicity);
+
+    // generate a random number of stars
+    for(int i=0; i<system.multiplicity; ++i) {
+      //cout << "  starting star id " << i << "\n";
+      // create at least one star
+      //cout << "  star " << i+1 << "\n";
+      UniverseStar star = genStar(starSeeds[i]);
+      system.stars[starSeeds[i]] = star;
+    }
+    //cout << "  generated " << system.multiplicity << " star"
+    //  << (system.multiplicity==1? "":"s") <<".\n";
+
+    // TODO: generate orbitals for all stars
+
+  } // end function
+
+
+  //---------------------------------
+  // single attribute generation
+  //---------------------------------
+
+  /**
+   * @brief Selects the random stream of an attribute.
+   * With ATTRIBUTE_STREAMS the generator is reseeded to
+   * pcg32(seed, attribute), otherwise it is left as is
+   * and the attribute continues the sequential draws.
+   * @return rng - the given generator
+   */
+  pcg32& attributeStream(pcg32 &rng, uint64_t seed, GEN_ATTRIBUTE attribute) const {
+    if (ATTRIBUTE_STREAMS) {
+      rng.seed(seed, attribute);
+    }
+    return rng;
+  }
+
+  /**
+   * @brief Returns a generator positioned at the first draw
+   * of an attribute, without drawing the ones before it.
+   * Sequential draws are skipped with pcg32::advance.
+   * @param sequentialDraws - draws before the attribute
+   *   in the sequential generation
+   */
+  pcg32 attributeStream(uint64_t seed, GEN_ATTRIBUTE attribute, int64_t sequentialDraws) const {
+    pcg32 rng(seed);
+    if (ATTRIBUTE_STREAMS) {
+      rng.seed(seed, attribute);
+    } else {
+      rng.advance(sequentialDraws);
+    }
+    return rng;
+  }
+
+  /**
+   * @brief Number of stars of a system, as genSystemData
+   * would generate it, without the system position.
+   */
+  int multiplicityOf(const uint64_t systemSeed) const {
+    pcg32 rng = attributeStream(systemSeed, ATTR_SYSTEM_MULTIPLICITY, 3);
+    return starSystemMultiSampler.sample(rng.nextFloat()) + 1;
+  }
+
+  /**
+   * @brief Star type index (see starTypeProbability), as genStar
+   * would generate it, without generating the star.
+   */
+  int starTypeOf(const uint64_t starSeed) const {
+    pcg32 rng = attributeStream(starSeed, ATTR_STAR_TYPE, 0);
+    return starTypeSampler.sample(rng.nextFloat());
+  }
+
+  /**
+   * @brief Star photosphere temperature in [K], as genStar
+   * would generate it, e.g. for map colors.
+   */
+  float starTemperatureOf(const uint64_t starSeed) const {
+    int idx = starTypeOf(starSeed);
+    pcg32 rng = attributeStream(starSeed, ATTR_STAR_TEMPERATURE, 3);
+    return minTemperature[idx] + rng.nextFloat()*(maxTemperature[idx] - minTemperature[idx]);
+  }
+
+  /**
+   * @brief Number of planets of a star, as genStar
+   * would generate it, without generating the star.
+   */
+  uint planetCountOf(const uint64_t starSeed) const {
+    pcg32 rng = attributeStream(starSeed, ATTR_STAR_PLANETS, 4);
+    return rng.nextUInt(8);
+  }
+
+
+  //---------------------------------
+  // system summaries
+  //---------------------------------
+
+  /**
+   * @brief Generates the map level fields of a system:
+   * position, multiplicity, and type, temperature and
+   * color of the dominant (most massive) star.
+   * Only the star type, mass and temperature are drawn;
+   * radius, luminosity, habitable zone, frost limit and
+   * planets are not generated.
+   * @param systemSeed - system seed, e.g. from getSystemSeeds
+   * @return summary - as genSystemData and genStar generate it
+   */
+  SystemSummary genSystemSummary(const uint64_t systemSeed) const {
+    SystemSummary summary;
+    summary.seed = systemSeed;
+
+    // position and multiplicity as in genSystemData
+    pcg32 rng(systemSeed);
+    attributeStream(rng, systemSeed, ATTR_SYSTEM_POSITION);
+    for (int i=0; i<3; ++i) {
+      summary.position[i] = (float)(rng.nextDouble() * SECTOR_SIZE_LY);
+    }
+    float rnum = attributeStream(rng, systemSeed, ATTR_SYSTEM_MULTIPLICITY).nextFloat();
+    summary.multiplicity = (uint8_t)(starSystemMultiSampler.sample(rnum) + 1);
+
+    // type, mass and temperature of each star as in genStar
+    std::vector<uint64_t> starSeeds = getStarSeeds(systemSeed, summary.multiplicity);
+    float dominantMass = -1.0f;
+    for (int i=0; i<summary.multiplicity; ++i) {
+      const uint64_t starSeed = starSeeds[i];
+      rng.seed(starSeed);
+      int idx = starTypeSampler.sample(attributeStream(rng, starSeed, ATTR_STAR_TYPE).nextFloat());
+      float massMin = minMass[idx];
+      float massMax = maxMass[idx];
+      float mass = massMin + attributeStream(rng, starSeed, ATTR_STAR_MASS).nextFloat()*(massMax-massMin);
+      if (mass<=dominantMass) { continue; }
+
+      // skip the radius
+      attributeStream(rng, starSeed, ATTR_STAR_RADIUS).advance(1);
+      float temperatureMin = minTemperature[idx];
+      float temperatureMax = maxTemperature[idx];
+      summary.temperature = temperatureMin + attributeStream(rng, starSeed, ATTR_STAR_TEMPERATURE).nextFloat()*(temperatureMax - temperatureMin);
+      summary.typeIndex = (uint8_t)idx;
+      summary.temperatureSubclass = (int8_t)genStarTemperatureSubclass(idx, summary.temperature);
+      summary.dominantStar = (uint8_t)i;
+      dominantMass = mass;
+    }
+
+    std::vector<byte> color = STAR_COLOR_TABLE ? getStarColorTabled(summary.temperature) : getStarColor(summary.temperature);
+    std::copy_n(color.begin(), 3, summary.color);
+
+    return summary;
+  }
+
+  /**
+   * @brief System summaries of all systems of a sector
+   * in getSystemSeeds order, e.g. for a zoomed out map.
+   * @param sectorSeed - sector seed, e.g. from sectorRange
+   */
+  std::vector<SystemSummary> genSystemSummaries(const uint64_t sectorSeed) const {
+    std::vector<uint64_t> systemSeeds = getSystemSeeds(sectorSeed);
+    std::vector<SystemSummary> summaries(systemSeeds.size());
+    for (size_t i=0; i<systemSeeds.size(); ++i) {
+      summaries[i] = genSystemSummary(systemSeeds[i]);
+    }
+    return summaries;
+  }
+
+
+  //---------------------------------
+  // generate universe planet data
+  //---------------------------------
+
+  /**
+   * Generate a planet for a parent star
+   * @param planetSeed - seed for generating further data
+   * @param star - parent star mass is required for planet
+   *   mas density calculaiton
+   * @param planetDistanceAu - planet distanc from the
+   *   parent star
+   * @param lowerLimitAu - start of the mass accretion
+   *   distance from parent star
+   * @return planet - UniversePlanet object
+   */
+  UniversePlanet genPlanet(uint64_t planetSeed, UniverseStar &star, float planetDistanceAu, float &lowerLimitAu) {
+    return genPlanet(planetSeed, star, planetDistanceAu, lowerLimitAu, rng);
+  }
+
+  /**
+   * @brief Mass accreted by a planet between the lower
+   * and upper limit in [kg]
+   */
+  float accretedMass(const UniverseStar &star, float planetDistanceAu, float lowerLimitAu, float upperLimitAu) const {
+    // average mass density in [kg * au^⁻1] taken at the
+    // planet distance
+    float massDensity = getStarMassDensity(star.mass, star.frostLimitAu, planetDistanceAu, FAST_MATH);
+    // linear interpolation of the mass between lower and upper limit
+    return massDensity * (upperLimitAu-lowerLimitAu);
+  }
+
+  /**
+   * Generate a planet for a parent star using the given
+   * random generator instead of the galaxy generator.
+   * The generator is reseeded with the planet seed and
+   * left in its final state, as genPlanets continues
+   * drawing the next planet distance from it.
+   * @param rng - random generator to use
+   */
+  UniversePlanet genPlanet(uint64_t planetSeed, const UniverseStar &star, float planetDistanceAu, float &lowerLimitAu, pcg32 &rng) const {
+    UniversePlanet planet = genPlanetBody(planetSeed, star, planetDistanceAu, lowerLimitAu, rng);
+    planet.atmosphere = createAtmosphere(planet.typeIndex, planet.radius, rng);
+    return planet;
+  }
+
+  /**
+   * Generates a planet like genPlanet but without its
+   * atmosphere, which is drawn next from the generator
+   * (createAtmosphere), e.g. after a query predicate.
+   */
+  UniversePlanet genPlanetBody(uint64_t planetSeed, const UniverseStar &star, float planetDistanceAu, float &lowerLimitAu, pcg32 &rng) const {
+    //cout << "generating planet : "
+    //  << "0x" << setw(16) << setfill('0') << hex << planetSeed << dec << " ("
+    //  << planetSeed << ") (" << sizeof(planetSeed) << " bytes)\n";
+
+    // init planet data container
+    UniversePlanet planet = UniversePlanet();
+
+    // set object seed
+    planet.seed = planetSeed;
+    rng.seed(planetSeed);
+
+    /// generate planet object data
+
+    // generate position
+    planet.position = {planetDistanceAu, 0, 0};
+    planet.starDistance = planetDistanceAu;
+    if ( (planet.starDistance>star.hzDistAu[1]) & (planet.starDistance<star.hzDistAu[5]) ) {
+      planet.isInHz = true;
+    }
 
     // get the mass density at the planet position
     // by accretion of the mass between the lower limit
     // and the upper limit
     float upperLimitAu = planetDistanceAu + planetDistanceAu - lowerLimitAu;
-    // average mass density in [kg * au^⁻1] taken at the
-    // planet distance
-    float massDensity = getStarMassDensity(star.mass, star.frostLimitAu, planetDistanceAu);
-    // linear interpolation of the mass between lower and upper limit
-    planet.mass = massDensity * (upperLimitAu-lowerLimitAu);
+    planet.mass = accretedMass(star, planetDistanceAu, lowerLimitAu, upperLimitAu);
     // standard gravitational parameter (G*M)
     planet.mu = G * planet.mass;
 
-    // calculate planet temperature
-    planet.temperature = planetTemperature(star.luminosity, planetDistanceAu);
-    float deviation = rng.nextFloat() * 50.0f;
-    planet.equatorTemperature = planet.temperature + deviation;
-    deviation = rng.nextFloat() * 50.0f;
-    planet.poleTemperature = planet.temperature - deviation;
+    // calculate planet temperature
+    planet.temperature = planetTemperature(star.luminosity, planetDistanceAu);
+    float deviation = rng.nextFloat() * 50.0f;
+    planet.equatorTemperature = planet.temperature + deviation;
+    deviation = rng.nextFloat() * 50.0f;
+    planet.poleTemperature = planet.temperature - deviation;
+
+    //debug output
+    //cout << "  planet " << planet.seed << "\n";
+    //cout << "    frost limit [au] = " << star.frostLimitAu << "\n";
+    //cout << "    lowerLimitAu = " << lowerLimitAu << "\n";
+    //cout << "    planetDistanceAu = " << planetDistanceAu << "\n";
+    //cout << "    upperLimitAu = " << upperLimitAu << "\n";
+    //cout << "    planetTemperature [K] = " << planet.temperature << "\n";
+    //cout << "    massDensity [kg*au^⁻1] = " << massDensity << "\n";
+    //cout << "    mass [kg] = " << planet.mass << "\n";
+    //cout << "    mass [Mearth] = " << planet.mass/Mearth << "\n";
+
+    // update limits for the next planet in loop
+    lowerLimitAu = upperLimitAu;
+
+    // generate planet periodic type
+    planet.typeIndex = getPlanetTypeIndex(planet, star.hzDistAu[1], star.hzDistAu[5]);
+
+    // generate planet radius in [km]
+    planet.radius = Rearth_min[planet.typeIndex] + rng. nextFloat() * (Rearth_max[planet.typeIndex]-Rearth_min[planet.typeIndex]);
+    planet.radius *= Rearth;
+
+    // generate axial rotation (day)
+    // planet day (duration of one axis rotation in [s]
+    // TODO: can be improved by correlating planet type, mass, density, and radius
+    planet.day = 2 * M_PI * planet.radius;
+
+    // update orbital period (year) in [s]
+    // we use a simple method, using the semi major axis in
+    // [au], for orbital period P in []:
+    // P = sqrt{a^3} where
+    //   p, is the period in Earth years and a, is the semi
+    //   major axis, in Astronomical Units.
+    // TODO: can be improved by correlating planet type,
+    // mass, density, and radius
+    planet.year = sqrt(pow(planet.starDistance, 3)) * yearEarth;
+
+    // the atmosphere is generated by genPlanet
+
+    //TODO: enerate more planet parameters
+    //TODO: generate moons
+
+    return planet;
+  }
+
+  /**
+   * Generates new planets in the system in accordance with the
+   * nebular hypothesis.
+   * Frost line (FL), where temperature is estimated to be about 150 K.
+   * Small rocky planets form inward from the FL.
+   * Larger gaseous planets form outward from the FL.
+   * Rocky elements density ~4e24 kg/au, with
+   * - min = 4e23 kg/au close to the sun (non-adhesion in melted state)
+   * - max = 9e24 (accretion in semi-melted state)
+   * - it follows a normal distribution between 0 au and the FL
+   * Gas element density decreases exponentially
+   * - from 2.5e26 at the frost line
+   * - to 3e24 at 30 au
+   * - it follows an inverse exponential function from the FL on
+   */
+  void genPlanets(uint64_t systemSeed, uint64_t starSeed) {
+    //cout << "       generating planets : ";
+    UniverseStar &star = systems[systemSeed].stars[starSeed];
+    star.seed = starSeed;
+    genPlanets(star);
+  } // end genPlanets function
+
+  /**
+   * @brief Layout pass of genPlanets: the distances and
+   * accretion limits of all planets of a star.
+   * The distances are drawn from the generator that each
+   * planet reseeds with its seed, so the draws of a planet
+   * are skipped here (its type decides the atmosphere
+   * draws), which only needs the accreted mass.
+   * @param star - star with seed, planetsCount, mass,
+   *   frost limit and habitable zone
+   * @return orbits - one per planet, inner to outer
+   */
+  std::vector<PlanetOrbit> genPlanetOrbits(const UniverseStar &star) const {
+    // set generator to star
+    pcg32 rng(star.seed);
+
+    // get planet seeds for this system
+    vector<uint64_t> planetSeeds = getPlanetSeeds(star.seed, star.planetsCount);
+    std::vector<PlanetOrbit> orbits(star.planetsCount);
+
+    // init data for random planet position within the frost limit
+    // TODO: how to assure that not too many small planets are generated?
+    float lowerLimitAu = 0;
+    float planetDistanceAu = 0.0f;
+
+    for(int i=0; i<(int)star.planetsCount; ++i) {
+
+      // randomized planet distance from the star
+      if (lowerLimitAu<star.frostLimitAu) {
+          // inward of the frost limit
+          planetDistanceAu = lowerLimitAu + 0.1f + rng.nextFloat() * (star.frostLimitAu - lowerLimitAu);
+      } else  {
+          // outward of the frost limit
+          // max distance between planets
+          // TODO: take into expression the possible system size based on the star mass
+          planetDistanceAu *= 1.5f + rng.nextFloat();
+          if (planetDistanceAu<=lowerLimitAu) {
+              planetDistanceAu += lowerLimitAu;
+          }
+      }
+      orbits[i] = PlanetOrbit{planetSeeds[i], planetDistanceAu, lowerLimitAu};
+
+      // replay the generator of genPlanet:
+      // two temperature deviations and the radius, then the atmosphere
+      float upperLimitAu = planetDistanceAu + planetDistanceAu - lowerLimitAu;
+      float mass = accretedMass(star, planetDistanceAu, lowerLimitAu, upperLimitAu);
+      int typeIndex = getPlanetTypeIndex(planetDistanceAu, mass, star.hzDistAu[1], star.hzDistAu[5]);
+      rng.seed(planetSeeds[i]);
+      rng.advance(3);
+      skipAtmosphere(typeIndex, rng);
+
+      // update limits for the next planet in loop
+      lowerLimitAu = upperLimitAu;
+
+    } // loop planet
+
+    return orbits;
+  } // end genPlanetOrbits function
+
+  /**
+   * @brief Generates a planet from its orbit (see
+   * genPlanetOrbits) with its own generator, independent
+   * of the other planets of the star.
+   * @param orbit - planet seed, distance and lower limit
+   * @param star - parent star
+   * @return planet - UniversePlanet object
+   */
+  UniversePlanet genPlanet(const PlanetOrbit &orbit, const UniverseStar &star) const {
+    pcg32 rng;
+    float lowerLimitAu = orbit.lowerLimitAu;
+    return genPlanet(orbit.seed, star, orbit.distanceAu, lowerLimitAu, rng);
+  }
+
+  /**
+   * @brief Generates the planet at an index of a star
+   * without generating its siblings; equal to the planet
+   * genPlanets generates at this index.
+   * @param star - parent star (see genStar)
+   * @param index - planet index [0..planetsCount-1]
+   * @return planet - UniversePlanet object
+   */
+  UniversePlanet genPlanetByIndex(const UniverseStar &star, const uint index) const {
+    return genPlanet(genPlanetOrbits(star).at(index), star);
+  }
+
+  /**
+   * Generates the planets of a star object
+   * which need not be stored in the galaxy model.
+   * The orbits are laid out first (genPlanetOrbits),
+   * then each planet is generated on its own.
+   */
+  void genPlanets(UniverseStar &star) const {
+    for (const PlanetOrbit &orbit : genPlanetOrbits(star)) {
+      star.planets[orbit.seed] = genPlanet(orbit, star);
+    }
+  } // end genPlanets function
+
+
+  //---------------------------------
+  // generate complete objects
+  //---------------------------------
+
+  /**
+   * @brief Generates a system with all its stars and planets.
+   * The galaxy state is neither read nor modified (except for
+   * the configuration), so that any number of threads may
+   * generate systems from the same galaxy concurrently.
+   * @param systemSeed - system seed, e.g. from getSystemSeeds
+   * @return system - fully populated UniverseSystem object
+   */
+  UniverseSystem genSystemComplete(const uint64_t systemSeed) const {
+    UniverseSystem system = genSystemData(systemSeed);
+    genStars(system);
+    for (auto& [starSeed, star] : system.stars) {
+      genPlanets(star);
+    }
+    return system;
+  }
+
+  /**
+   * @brief Generates a star with all its planets.
+   * The galaxy state is neither read nor modified.
+   * @param starSeed - star seed, e.g. from getStarSeeds
+   * @return star - fully populated UniverseStar object
+   */
+  UniverseStar genStarComplete(const uint64_t starSeed) const {
+    UniverseStar star = genStar(starSeed);
+    genPlanets(star);
+    return star;
+  }
+
+
+  /**
+   * @brief Generates all systems of a sector region with
+   * their stars and planets into a columnar store.
+   * @param store - store to append the systems to
+   * @param region - sectors to generate, clipped to the galaxy
+   */
+  void genStore(UniverseStore &store, const SectorRegion &region) const {
+    for (SectorCoordinate sector : sectorRange(region)) {
+      for (uint64_t systemSeed : getSystemSeeds(sector.seed)) {
+        UniverseSystem system = genSystemComplete(systemSeed);
+        system.sector = sector.seed;
+        store.append(system);
+      }
+    }
+  }
+
+
+  //---------------------------------
+  // spatial system queries
+  //---------------------------------
+
+  /**
+   * @brief Returns the region of sectors overlapping a box
+   * given in galaxy coordinates in [ly].
+   * Sector (x,y,z) covers [x,x+1)*SECTOR_SIZE_LY in each axis.
+   */
+  SectorRegion getSectorRegion(const std::vector<double> &minLy, const std::vector<double> &maxLy) const {
+    SectorRegion region;
+    region.xMin = (int)floor(minLy[0]/SECTOR_SIZE_LY);
+    region.yMin = (int)floor(minLy[1]/SECTOR_SIZE_LY);
+    region.zMin = (int)floor(minLy[2]/SECTOR_SIZE_LY);
+    region.xMax = (int)floor(maxLy[0]/SECTOR_SIZE_LY) + 1;
+    region.yMax = (int)floor(maxLy[1]/SECTOR_SIZE_LY) + 1;
+    region.zMax = (int)floor(maxLy[2]/SECTOR_SIZE_LY) + 1;
+    return region;
+  }
+
+  /**
+   * @brief Calls visit(sector, systemSeed, positionLy) for every
+   * system in the sectors of the region.
+   * Systems are taken from the galaxy model if present,
+   * otherwise only their position is generated.
+   */
+  template <typename Visitor>
+  void visitSystemsInRegion(const SectorRegion &region, Visitor visit) const {
+    std::vector<double> positionLy(3);
+    for (SectorCoordinate sector : sectorRange(region)) {
+      for (uint64_t systemSeed : getSystemSeeds(sector.seed)) {
+        auto found = systems.find(systemSeed);
+        std::vector<double> position = (found != systems.end())
+          ? found->second.position : genSystemData(systemSeed).position;
+        positionLy[0] = sector.x * SECTOR_SIZE_LY + position[0];
+        positionLy[1] = sector.y * SECTOR_SIZE_LY + position[1];
+        positionLy[2] = sector.z * SECTOR_SIZE_LY + position[2];
+        visit(sector, systemSeed, positionLy);
+      }
+    }
+  }
+
+  /**
+   * @brief Finds all systems inside an axis aligned box.
+   * Only the sectors overlapping the box are visited.
+   * @param minLy - lower box corner in galaxy coordinates [ly]
+   * @param maxLy - upper box corner in galaxy coordinates [ly]
+   * @return systems inside the box in sector order
+   */
+  std::vector<SystemQueryResult> querySystemsInBox(const std::vector<double> &minLy, const std::vector<double> &maxLy) const {
+    std::vector<SystemQueryResult> results;
+    visitSystemsInRegion(getSectorRegion(minLy, maxLy),
+      [&](const SectorCoordinate &sector, uint64_t systemSeed, const std::vector<double> &positionLy) {
+        for (int i=0; i<3; ++i) {
+          if ((positionLy[i]<minLy[i]) | (positionLy[i]>maxLy[i])) { return; }
+        }
+        SystemQueryResult result;
+        result.systemSeed = systemSeed;
+        result.sectorSeed = sector.seed;
+        result.position = positionLy;
+        results.push_back(result);
+      });
+    return results;
+  }
+
+  /**
+   * @brief Finds all systems within a radius around a point.
+   * Only the sectors overlapping the bounding box
+   * of the sphere are visited.
+   * @param centerLy - query center in galaxy coordinates [ly]
+   * @param radiusLy - query radius in [ly]
+   * @return systems within the radius, nearest first
+   */
+  std::vector<SystemQueryResult> querySystemsInRadius(const std::vector<double> &centerLy, double radiusLy) const {
+    std::vector<SystemQueryResult> results;
+    std::vector<double> minLy = {centerLy[0]-radiusLy, centerLy[1]-radiusLy, centerLy[2]-radiusLy};
+    std::vector<double> maxLy = {centerLy[0]+radiusLy, centerLy[1]+radiusLy, centerLy[2]+radiusLy};
+    visitSystemsInRegion(getSectorRegion(minLy, maxLy),
+      [&](const SectorCoordinate &sector, uint64_t systemSeed, const std::vector<double> &positionLy) {
+        double dx = positionLy[0]-centerLy[0];
+        double dy = positionLy[1]-centerLy[1];
+        double dz = positionLy[2]-centerLy[2];
+        double distance = sqrt(dx*dx + dy*dy + dz*dz);
+        if (distance>radiusLy) { return; }
+        SystemQueryResult result;
+        result.systemSeed = systemSeed;
+        result.sectorSeed = sector.seed;
+        result.position = positionLy;
+        result.distance = distance;
+        results.push_back(result);
+      });
+    std::sort(results.begin(), results.end(),
+      [](const SystemQueryResult &a, const SystemQueryResult &b) { return a.distance < b.distance; });
+    return results;
+  }
+
+  /**
+   * @brief Finds the k nearest systems to a point.
+   * The search radius starts at one sector edge length
+   * and doubles until k systems are found or the
+   * search covers the whole galaxy.
+   * @param centerLy - query center in galaxy coordinates [ly]
+   * @param k - number of systems to find
+   * @return up to k systems, nearest first
+   */
+  std::vector<SystemQueryResult> querySystemsNearest(const std::vector<double> &centerLy, size_t k) const {
+    std::vector<SystemQueryResult> results;
+    if (k==0) { return results; }
+    SectorRegion bounds = getSectorBounds();
+    for (double radiusLy = SECTOR_SIZE_LY; ; radiusLy *= 2.0) {
+      results = querySystemsInRadius(centerLy, radiusLy);
+      if (results.size()>=k) { break; }
+      // stop when the search box contains the whole galaxy
+      SectorRegion region = getSectorRegion(
+        {centerLy[0]-radiusLy, centerLy[1]-radiusLy, centerLy[2]-radiusLy},
+        {centerLy[0]+radiusLy, centerLy[1]+radiusLy, centerLy[2]+radiusLy});
+      if (region.intersect(bounds).size()==bounds.size()) { break; }
+    }
+    if (results.size()>k) { results.resize(k); }
+    return results;
+  }
+
+
+  //---------------------------------
+  // staged queries
+  //---------------------------------
+
+  /**
+   * @brief Searches systems with predicates per generation
+   * stage (see GalaxyQuery). Systems are generated in the
+   * sectors of the search sphere; stars, planets and
+   * atmospheres only below accepted objects, so expensive
+   * stages are skipped for pruned subtrees.
+   * @param query - search sphere and predicates
+   * @param stats - optional counters per QUERY_LEVEL
+   * @return matching systems in sector order
+   */
+  std::vector<SystemQueryMatch> querySystems(const GalaxyQuery &query, GalaxyQueryStats *stats=nullptr) const {
+    GalaxyQueryStats counters;
+    std::vector<SystemQueryMatch> matches;
+    const bool sphere = query.radiusLy>=0;
+    const bool withPlanets = query.planet || query.atmosphere;
+    const std::vector<double> &centerLy = query.centerLy;
+    SectorRegion region = sphere
+      ? getSectorRegion(
+          {centerLy[0]-query.radiusLy, centerLy[1]-query.radiusLy, centerLy[2]-query.radiusLy},
+          {centerLy[0]+query.radiusLy, centerLy[1]+query.radiusLy, centerLy[2]+query.radiusLy})
+      : getSectorBounds();
+
+    for (SectorCoordinate sector : sectorRange(region)) {
+      for (uint64_t systemSeed : getSystemSeeds(sector.seed)) {
+        // system stage: position and multiplicity
+        SystemQueryMatch match;
+        UniverseSystem &system = match.system;
+        system = genSystemData(systemSeed);
+        system.sector = sector.seed;
+        counters.generated[QUERY_SYSTEM]++;
+        SystemQueryResult &location = match.location;
+        location.systemSeed = systemSeed;
+        location.sectorSeed = sector.seed;
+        location.position = {
+          sector.x * SECTOR_SIZE_LY + system.position[0],
+          sector.y * SECTOR_SIZE_LY + system.position[1],
+          sector.z * SECTOR_SIZE_LY + system.position[2]
+        };
+        if (sphere) {
+          double dx = location.position[0]-centerLy[0];
+          double dy = location.position[1]-centerLy[1];
+          double dz = location.position[2]-centerLy[2];
+          location.distance = sqrt(dx*dx + dy*dy + dz*dz);
+        }
+        if ((sphere && location.distance>query.radiusLy) || (query.system && !query.system(system))) {
+          counters.rejected[QUERY_SYSTEM]++;
+          counters.pruned[QUERY_STAR] += system.multiplicity;
+          if (withPlanets) {
+            for (uint64_t starSeed : getStarSeeds(systemSeed, system.multiplicity)) {
+              uint planets = planetCountOf(starSeed);
+              counters.pruned[QUERY_PLANET] += planets;
+              counters.pruned[QUERY_ATMOSPHERE] += planets;
+            }
+          }
+          continue;
+        }
+
+        // star stage
+        for (uint64_t starSeed : getStarSeeds(systemSeed, system.multiplicity)) {
+          UniverseStar star = genStar(starSeed);
+          counters.generated[QUERY_STAR]++;
+          if (query.star && !query.star(star)) {
+            counters.rejected[QUERY_STAR]++;
+            if (withPlanets) {
+              counters.pruned[QUERY_PLANET] += star.planetsCount;
+              counters.pruned[QUERY_ATMOSPHERE] += star.planetsCount;
+            }
+            continue;
+          }
+          if (withPlanets && !queryPlanets(query, star, counters)) { continue; }
+          system.stars[starSeed] = std::move(star);
+        }
+        if (system.stars.empty()) { continue; }
+
+        counters.matched[QUERY_SYSTEM]++;
+        counters.matched[QUERY_STAR] += system.stars.size();
+        for (auto& [starSeed, star] : system.stars) {
+          counters.matched[QUERY_PLANET] += star.planets.size();
+          for (auto& [planetSeed, planet] : star.planets) {
+            counters.matched[QUERY_ATMOSPHERE] += planet.atmosphere.radius>0;
+          }
+        }
+        matches.push_back(std::move(match));
+      }
+    }
+
+    if (stats) { *stats = counters; }
+    return matches;
+  }
+
+  /**
+   * @brief Planet and atmosphere stages of querySystems:
+   * adds the matching planets to the star.
+   * Orbits are laid out for all planets (genPlanetOrbits),
+   * atmospheres are only generated for accepted planets.
+   * @return true if at least one planet matches
+   */
+  bool queryPlanets(const GalaxyQuery &query, UniverseStar &star, GalaxyQueryStats &counters) const {
+    for (const PlanetOrbit &orbit : genPlanetOrbits(star)) {
+      pcg32 rng;
+      float lowerLimitAu = orbit.lowerLimitAu;
+      UniversePlanet planet = genPlanetBody(orbit.seed, star, orbit.distanceAu, lowerLimitAu, rng);
+      counters.generated[QUERY_PLANET]++;
+      if (query.planet && !query.planet(planet)) {
+        counters.rejected[QUERY_PLANET]++;
+        counters.pruned[QUERY_ATMOSPHERE]++;
+        continue;
+      }
+      planet.atmosphere = createAtmosphere(planet.typeIndex, planet.radius, rng);
+      counters.generated[QUERY_ATMOSPHERE]++;
+      if (query.atmosphere && !query.atmosphere(planet)) {
+        counters.rejected[QUERY_ATMOSPHERE]++;
+        continue;
+      }
+      star.planets[orbit.seed] = std::move(planet);
+    }
+    return !star.planets.empty();
+  }
+
+
+  //---------------------------------
+  // generate whole galaxy in parallel
+  //---------------------------------
+
+  /**
+   * @brief Generates all sectors, systems, stars and planets
+   * of the galaxy, spreading the systems over several threads.
+   * The result is identical to the serial pipeline
+   * (genSectors, genSystemsAt, genSystem, genStars, genPlanets)
+   * for the same galaxy seed, since every object is generated
+   * from its own seed only.
+   * Sectors and system map entries are created serially,
+   * the workers then only fill in their own system entries.
+   * @param threads - number of threads, 0 uses THREADS
+   *   or all hardware threads if THREADS is 0 as well
+   */
+  void genGalaxyParallel(unsigned int threads=0) {
+    if (threads==0) { threads = THREADS; }
+    if (threads==0) { threads = std::thread::hardware_concurrency(); }
+    if (threads==0) { threads = 1; }
+
+    // create sectors and system entries serially
+    genSectors();
+    std::vector<std::map<uint64_t, UniverseSystem>::iterator> work;
+    for (auto& [key, sector] : sectors) {
+      genSystemsAt(key);
+      for (auto& systemSeed : sector.systemSeeds) {
+        work.push_back(systems.try_emplace(systemSeed).first);
+      }
+    }
+    // systems shared by several sectors are generated once
+    auto bySeed = [](auto &a, auto &b) { return a->first < b->first; };
+    auto sameSeed = [](auto &a, auto &b) { return a->first == b->first; };
+    std::sort(work.begin(), work.end(), bySeed);
+    work.erase(std::unique(work.begin(), work.end(), sameSeed), work.end());
+
+    // generate system objects concurrently
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+      for (size_t i = next++; i < work.size(); i = next++) {
+        work[i]->second = genSystemComplete(work[i]->first);
+      }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned int t=1; t<threads; ++t) {
+      pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+      thread.join();
+    }
+  } // end genGalaxyParallel function
+
+}; // end class ProcUGalaxy
+
+
+//-----------------------------------
+// libProcU procu::ProcUSystemCache
+//-----------------------------------
+
+/**
+ * @brief Heap buffer of a string in [bytes],
+ * 0 for short strings stored inline.
+ */
+size_t getStringHeapSize(const std::string &text) {
+  return text.capacity()>std::string().capacity() ? text.capacity() + 1 : 0;
+}
+
+/**
+ * @brief Estimates the memory held by a system object
+ * including its stars, planets and atmospheres in [bytes].
+ * Map nodes are counted with four pointers of overhead.
+ */
+size_t getSystemMemorySize(const UniverseSystem &system) {
+  const size_t nodeOverhead = 4 * sizeof(void*);
+  size_t bytes = sizeof(UniverseSystem);
+  bytes += system.position.capacity() * sizeof(double);
+  bytes += getStringHeapSize(system.name);
+  for (auto& [starSeed, star] : system.stars) {
+    bytes += nodeOverhead + sizeof(uint64_t) + sizeof(UniverseStar);
+    bytes += star.position.capacity() * sizeof(double);
+    bytes += star.color.capacity() * sizeof(byte);
+    bytes += getStringHeapSize(star.name);
+    for (auto& [planetSeed, planet] : star.planets) {
+      bytes += nodeOverhead + sizeof(uint64_t) + sizeof(UniversePlanet);
+      bytes += planet.position.capacity() * sizeof(double);
+      bytes += planet.baseColor.capacity() * sizeof(byte);
+      bytes += getStringHeapSize(planet.name);
+    }
+  }
+  return bytes;
+}
+
+/**
+ * @brief Counters of the system cache.
+ */
+struct CacheStats {
+  // lookups served from the cache
+  uint64_t hits = 0;
+  // lookups that generated the system
+  uint64_t misses = 0;
+  // systems dropped to stay within the budget
+  uint64_t evictions = 0;
+  // estimated memory of cached systems in [bytes]
+  size_t bytes = 0;
+  // number of cached systems
+  size_t entries = 0;
+};
+
+/**
+ * @brief Memory bounded cache of complete systems
+ * (stars and planets) with least recently used eviction.
+ * Evicted systems are regenerated from their seed on the
+ * next access with ProcUGalaxy::genSystemComplete, so the
+ * galaxy must outlive the cache.
+ * Lookups are thread-safe. Returned systems stay valid
+ * while held, even if evicted meanwhile.
+ * 
+ * @example
+ *   ProcUSystemCache cache(galaxy, 256<<20); // 256 MB
+ *   auto system = cache.getSystem(systemSeed);
+ */
+class ProcUSystemCache {
+
+public:
+
+  /**
+   * Class constructor
+   * @param galaxy - galaxy generating the systems
+   * @param budgetBytes - memory budget in [bytes]
+   */
+  ProcUSystemCache(const ProcUGalaxy &galaxy, size_t budgetBytes)
+    : galaxy(galaxy), budgetBytes(budgetBytes) {}
+
+  /**
+   * @brief Returns the complete system for the seed,
+   * generating it on a cache miss.
+   */
+  std::shared_ptr<const UniverseSystem> getSystem(const uint64_t systemSeed) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto found = entries.find(systemSeed);
+      if (found != entries.end()) {
+        ++stats.hits;
+        // move to most recently used
+        lru.splice(lru.begin(), lru, found->second.lru);
+        return found->second.system;
+      }
+      ++stats.misses;
+    }
+
+    // generate without holding the lock
+    auto system = std::make_shared<const UniverseSystem>(galaxy.genSystemComplete(systemSeed));
+    size_t bytes = getSystemMemorySize(*system);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = entries.find(systemSeed);
+    if (found != entries.end()) {
+      // another thread was faster
+      return found->second.system;
+    }
+    lru.push_front(systemSeed);
+    entries[systemSeed] = Entry{system, bytes, lru.begin()};
+    stats.bytes += bytes;
+    evict();
+    return system;
+  }
+
+  /**
+   * @brief Sets a new memory budget in [bytes]
+   * and evicts systems above it.
+   */
+  void setBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    budgetBytes = bytes;
+    evict();
+  }
+
+  /**
+   * @brief Returns a copy of the cache counters.
+   */
+  CacheStats getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    CacheStats result = stats;
+    result.entries = entries.size();
+    return result;
+  }
+
+  /**
+   * @brief Drops all cached systems, keeping the counters.
+   */
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    lru.clear();
+    stats.bytes = 0;
+  }
+
+private:
+
+  struct Entry {
+    std::shared_ptr<const UniverseSystem> system;
+    size_t bytes;
+    std::list<uint64_t>::iterator lru;
+  };
+
+  // drop least recently used systems above budget,
+  // but always keep the most recent one
+  void evict() {
+    while ((stats.bytes > budgetBytes) & (lru.size() > 1)) {
+      auto found = entries.find(lru.back());
+      stats.bytes -= found->second.bytes;
+      entries.erase(found);
+      lru.pop_back();
+      ++stats.evictions;
+    }
+  }
+
+  const ProcUGalaxy &galaxy;
+  size_t budgetBytes;
+  // system seeds, most recently used first
+  std::list<uint64_t> lru;
+  std::unordered_map<uint64_t, Entry> entries;
+  CacheStats stats;
+  mutable std::mutex mutex;
+
+}; // end class ProcUSystemCache
+
+
+//-----------------------------------
+// libProcU Universe serialization
+//-----------------------------------
+
+/**
+ * @brief Universe serialization must define
+ * to_json and from_json functions for all
+ * universe data structures.
+ */
+
+// de-/serializer for Universe Atmosphere
+
+/**
+ * @brief JSON serializer for planet atmosphere,
+ * composition as {gas name: volume part}
+ */
+void to_json(json& j, const UniverseAtmosphere& atmosphere) {
+    json jComposition = json::object();
+    for (int gas=0; gas<GAS_COUNT; ++gas) {
+      if (atmosphere.composition.has(gas)) {
+        jComposition[componentOrder[gas]] = atmosphere.composition.get(gas);
+      }
+    }
+    j = json{{"radius", atmosphere.radius}, {"pressure", atmosphere.pressure},
+      {"composition", jComposition}};
+}
+
+/**
+ * @brief gas index for a composition name, -1 if unknown
+ */
+int gasIndex(const std::string &name) {
+  for (int gas=0; gas<GAS_COUNT; ++gas) {
+    if (componentOrder[gas]==name) { return gas; }
+  }
+  return -1;
+}
+
+/**
+ * @brief JSON deserializer for planet atmosphere
+ */
+void from_json(const json& j, UniverseAtmosphere& atmosphere) {
+    atmosphere.radius = j.value("radius", 0.0f);
+    atmosphere.pressure = j.value("pressure", 0.0f);
+    atmosphere.composition = AtmosphereComposition();
+    if (j.contains("composition")) {
+      for (auto& [name, part] : j.at("composition").items()) {
+        int gas = gasIndex(name);
+        if (gas>=0) { atmosphere.composition.set(gas, part.get<float>()); }
+      }
+    }
+}
 
-    //debug output
-    //cout << "  planet " << planet.seed << "\n";
-    //cout << "    frost limit [au] = " << star.frostLimitAu << "\n";
-    //cout << "    lowerLimitAu = " << lowerLimitAu << "\n";
-    //cout << "    planetDistanceAu = " << planetDistanceAu << "\n";
-    //cout << "    upperLimitAu = " << upperLimitAu << "\n";
-    //cout << "    planetTemperature [K] = " << planet.temperature << "\n";
-    //cout << "    massDensity [kg*au^⁻1] = " << massDensity << "\n";
-    //cout << "    mass [kg] = " << planet.mass << "\n";
-    //cout << "    mass [Mearth] = " << planet.mass/Mearth << "\n";
+// de-/serializer for Universe Planet
 
-    // update limits for the next planet in loop
-    lowerLimitAu = upperLimitAu;
+/**
+ * @brief JSON serializer for universe planet
+ */
+void to_json(json& j, const UniversePlanet& planet) {
+    j = json{
+      {"seed", planet.seed},
+      {"name", planet.name},
+      {"type", planet.typeIndex},
+      {"position", planet.position},
+      {"starDistance", planet.starDistance},
+      {"isInHz", planet.isInHz},
+      {"mass", planet.mass},
+      {"mu", planet.mu},
+      {"temperature", planet.temperature},
+      {"equatorTemperature", planet.equatorTemperature},
+      {"poleTemperature", planet.poleTemperature},
+      {"radius", planet.radius},
+      {"day", planet.day},
+      {"year", planet.year},
+      {"probTemp", planet.probTemp},
+      {"probGrav", planet.probGrav},
+      {"probAtmo", planet.probAtmo},
+      {"rotation", planet.rotation},
+      {"baseColor", planet.baseColor}
+    };
+    if (planet.atmosphere.radius>0) {
+      j["atmosphere"] = planet.atmosphere;
+    }
+}
 
-    // generate planet periodic type
-    planet.typeIndex = getPlanetTypeIndex(planet, star.hzDistAu[1], star.hzDistAu[5]);
+/**
+ * @brief JSON deserializer for universe planet
+ */
+void from_json(const json& j, UniversePlanet& planet) {
+    j.at("seed").get_to(planet.seed);
+    planet.name = j.value("name", planet.name);
+    planet.typeIndex = j.value("type", planet.typeIndex);
+    planet.position = j.value("position", planet.position);
+    planet.starDistance = j.value("starDistance", planet.starDistance);
+    planet.isInHz = j.value("isInHz", planet.isInHz);
+    planet.mass = j.value("mass", planet.mass);
+    planet.mu = j.value("mu", planet.mu);
+    planet.temperature = j.value("temperature", planet.temperature);
+    planet.equatorTemperature = j.value("equatorTemperature", 0.0f);
+    planet.poleTemperature = j.value("poleTemperature", 0.0f);
+    planet.radius = j.value("radius", planet.radius);
+    planet.day = j.value("day", planet.day);
+    planet.year = j.value("year", planet.year);
+    planet.probTemp = j.value("probTemp", planet.probTemp);
+    planet.probGrav = j.value("probGrav", planet.probGrav);
+    planet.probAtmo = j.value("probAtmo", planet.probAtmo);
+    planet.rotation = j.value("rotation", planet.rotation);
+    planet.baseColor = j.value("baseColor", planet.baseColor);
+    if (j.contains("atmosphere")) {
+      j.at("atmosphere").get_to(planet.atmosphere);
+    }
+}
 
-    // generate planet radius in [km]
-    planet.radius = Rearth_min[planet.typeIndex] + rng. nextFloat() * (Rearth_max[planet.typeIndex]-Rearth_min[planet.typeIndex]);
-    planet.radius *= Rearth;
+// de-/serializer for Universe Star
 
-    // generate axial rotation (day)
-    // planet day (duration of one axis rotation in [s]
-    // TODO: can be improved by correlating planet type, mass, density, and radius
-    planet.day = 2 * M_PI * planet.radius;
+/**
+ * @brief JSON serializer for universe star
+ */
+void to_json(json& j, const UniverseStar& star) {
+    j = json{
+      {"seed", star.seed},
+      {"name", star.name},
+      {"type", star.typeIndex},
+      {"temperatureSubclass", star.temperatureSubclass},
+      {"position", star.position},
+      {"mass", star.mass},
+      {"luminosity", star.luminosity},
+      {"temperature", star.temperature},
+      {"radius", star.radius},
+      {"color", star.color},
+      {"hzDistAu", std::vector<float>(star.hzDistAu, star.hzDistAu+8)},
+      {"frostLimitAu", star.frostLimitAu},
+      {"planetsCount", star.planetsCount},
+      {"axialRotation", star.axialRotation}
+    };
 
-    // update orbital period (year) in [s]
-    // we use a simple method, using the semi major axis in
-    // [au], for orbital period P in []:
-    // P = sqrt{a^3} where
-    //   p, is the period in Earth years and a, is the semi
-    //   major axis, in Astronomical Units.
-    // TODO: can be improved by correlating planet type,
-    // mass, density, and radius
-    planet.year = sqrt(pow(planet.starDistance, 3)) * yearEarth;
+    // serialize planets
+    json jPlanet;
+    for (auto& [planetSeed, planet] : star.planets) {
+      jPlanet.push_back(planet);
+    }
+    if (star.planetsCount>0) {
+      j["planets"] = jPlanet;
+    }
+}
 
-    // TODO: generate atmosphere
-    //planet.createAtmosphere(rng);
-    planet.atmosphere = createAtmosphere(planet.typeIndex, planet.radius, rng);
+/**
+ * @brief JSON deserializer for universe star
+ */
+void from_json(const json& j, UniverseStar& star) {
+    j.at("seed").get_to(star.seed);
+    star.name = j.value("name", star.name);
+    star.typeIndex = j.value("type", star.typeIndex);
+    star.temperatureSubclass = j.value("temperatureSubclass", star.temperatureSubclass);
+    star.position = j.value("position", star.position);
+    star.mass = j.value("mass", star.mass);
+    star.luminosity = j.value("luminosity", star.luminosity);
+    star.temperature = j.value("temperature", star.temperature);
+    star.radius = j.value("radius", star.radius);
+    star.color = j.value("color", star.color);
+    std::vector<float> hzDistAu = j.value("hzDistAu", std::vector<float>(8, 0.0f));
+    std::copy_n(hzDistAu.begin(), std::min<size_t>(hzDistAu.size(), 8), star.hzDistAu);
+    star.frostLimitAu = j.value("frostLimitAu", star.frostLimitAu);
+    star.axialRotation = j.value("axialRotation", star.axialRotation);
+
+    star.planets.clear();
+    if (j.contains("planets")) {
+      for (auto& jPlanet : j.at("planets")) {
+        UniversePlanet planet = jPlanet.get<UniversePlanet>();
+        star.planets[planet.seed] = planet;
+      }
+    }
+    star.planetsCount = j.value("planetsCount", (uint)star.planets.size());
+}
 
-    //TODO: enerate more planet parameters
-    //TODO: generate moons
+// de-/serializer for Universe System
 
-    return planet;
+/**
+ * @brief JSON serializer for universe system
+ */
+void to_json(json& j, const UniverseSystem& system) {
+    //j = json{{"stars", system.stars}}; // cannot serialize maps directly
+    j = json{{"sector", system.sector}, {"seed", system.seed}, {"name", system.name},
+      {"position", system.position}, {"multiplicity", system.multiplicity}};
+
+    // The following insert a duplicated key record
+    // which is the star seed... We keep it for archival purpose
+    //json jStars(system.stars);
+    //j["stars"] = jStars;
+
+    // Therefore we prefer this iterative method
+    json jStar;
+    for (auto& [starSeed, star] : system.stars) {
+      jStar.push_back(star);
+    }
+    j["stars"] = jStar;
+}
+
+/**
+ * @brief JSON deserializer for universe system
+ */
+void from_json(const json& j, UniverseSystem& system) {
+    j.at("seed").get_to(system.seed);
+    system.sector = j.value("sector", (uint64_t)0);
+    system.name = j.value("name", system.name);
+    j.at("position").get_to(system.position);
+    system.multiplicity = j.value("multiplicity", system.multiplicity);
+    system.stars.clear();
+    if (j.contains("stars") && j.at("stars").is_array()) {
+      for (auto& jStar : j.at("stars")) {
+        UniverseStar star = jStar.get<UniverseStar>();
+        system.stars[star.seed] = star;
+      }
+    }
+}
+
+// de-/serializer for Universe Sector
+
+/**
+ * @brief JSON serializer for universe sector
+ */
+void to_json(json& j, const UniverseSector& sector) {
+    j = json{{"seed", sector.seed}, {"position", sector.position},
+      {"name", sector.name}, {"systems", sector.systemSeeds}};
+}
+
+/**
+ * @brief JSON deserializer for universe sector
+ */
+void from_json(const json& j, UniverseSector& sector) {
+    j.at("seed").get_to(sector.seed);
+    sector.position = j.value("position", sector.position);
+    sector.name = j.value("name", sector.name);
+    sector.systemSeeds = j.value("systems", sector.systemSeeds);
+}
+
+/**
+ * @brief JSON serializer for the sector table
+ * as [key, sector] pairs in table order
+ */
+void to_json(json& j, const SectorTable& sectors) {
+    j = json::array();
+    for (auto& [key, sector] : sectors) {
+      j.push_back(json{key, sector});
+    }
+}
+
+/**
+ * @brief JSON deserializer for the sector table
+ */
+void from_json(const json& j, SectorTable& sectors) {
+    sectors.clear();
+    sectors.reserve(j.size());
+    for (auto& entry : j) {
+      entry.at(1).get_to(sectors[entry.at(0).get<uint64_t>()]);
+    }
+}
+
+
+//-----------------------------------
+// libProcU streaming galaxy loader
+//-----------------------------------
+
+/**
+ * @brief Selects the sectors a loader materializes;
+ * called with seed, position and name of each sector
+ * (systems and stars are not loaded yet).
+ */
+using SectorFilter = std::function<bool(const UniverseSector&)>;
+
+/**
+ * @brief SAX event handler that builds sectors, systems,
+ * stars, planets and atmospheres directly into a galaxy
+ * while the document is parsed, without a json DOM.
+ * A stack of frames tracks the enclosing object or array;
+ * stars of systems in rejected sectors are only tokenized,
+ * never materialized.
+ * With a filter the stars are skipped only if the deciding
+ * keys of their system ("seed", or "sector" and
+ * "sectorPosition" for NDJSON) come before "stars", as in
+ * the sorted objects of json and saveGalaxy; otherwise they
+ * are materialized and the system is decided when it ends.
+ * Reads the document of saveGalaxy
+ *   {"galaxy":{..}, "sectors":[[key,{..}],..], "systems":[{..},..]}
+ * or, with systemDocuments, single system objects as
+ * written by exportRegionNdjson.
+ */
+class GalaxySaxHandler : public nlohmann::json_sax<json> {
+
+public:
+
+  /**
+   * @param galaxy - receives configuration, sectors and systems
+   * @param filter - sector selection, empty loads all
+   * @param systemDocuments - each document is a system
+   *   with "sectorPosition" (NDJSON lines)
+   */
+  GalaxySaxHandler(ProcUGalaxy &galaxy, const SectorFilter &filter, bool systemDocuments=false)
+    : galaxy(galaxy), filter(filter), systemDocuments(systemDocuments) {}
+
+  // parse error message of the last document
+  std::string error;
+  // materialized and skipped systems
+  size_t systemsLoaded = 0;
+  size_t systemsSkipped = 0;
+
+  // json_sax events
+
+  bool null() override { return true; }
+
+  bool boolean(bool val) override {
+    return number(val ? 1.0 : 0.0, val ? 1 : 0);
+  }
+
+  bool number_integer(number_integer_t val) override {
+    // casts back seeds stored bit-cast in BSON (toBsonIntegers)
+    return number((double)val, (uint64_t)val);
+  }
+
+  bool number_unsigned(number_unsigned_t val) override {
+    return number((double)val, val);
+  }
+
+  bool number_float(number_float_t val, const string_t&) override {
+    return number(val, val>0 ? (uint64_t)val : 0);
+  }
+
+  bool string(string_t &val) override {
+    Frame &frame = frames.back();
+    switch (frame.type) {
+      case FRAME_SECTOR: if (frame.key=="name") { sector.name = val; } break;
+      case FRAME_SYSTEM: if (frame.key=="name") { system.name = val; } break;
+      case FRAME_STAR: if (frame.key=="name") { star.name = val; } break;
+      case FRAME_PLANET: if (frame.key=="name") { planet.name = val; } break;
+      default: break;
+    }
+    return true;
+  }
+
+  bool key(string_t &val) override {
+    frames.back().key = val;
+    return true;
+  }
+
+  bool start_object(std::size_t) override {
+    const Frame &frame = frames.back();
+    int type = FRAME_SKIP;
+    switch (frame.type) {
+      case FRAME_ROOT:
+        type = systemDocuments ? FRAME_SYSTEM : FRAME_DOCUMENT;
+        break;
+      case FRAME_DOCUMENT:
+        if (frame.key=="galaxy") { type = FRAME_GALAXY; }
+        break;
+      case FRAME_SECTOR_ENTRY: type = FRAME_SECTOR; break;
+      case FRAME_SYSTEMS: type = FRAME_SYSTEM; break;
+      case FRAME_STARS: type = FRAME_STAR; break;
+      case FRAME_PLANETS: type = FRAME_PLANET; break;
+      case FRAME_PLANET:
+        if (frame.key=="atmosphere") { type = FRAME_ATMOSPHERE; }
+        break;
+      case FRAME_ATMOSPHERE:
+        if (frame.key=="composition") { type = FRAME_COMPOSITION; }
+        break;
+      default: break;
+    }
+    switch (type) {
+      case FRAME_SECTOR: sector = UniverseSector(); break;
+      case FRAME_SYSTEM:
+        system = UniverseSystem();
+        sectorPosition.clear();
+        seedRead = false;
+        sectorRead = false;
+        accepted = UNDECIDED;
+        break;
+      case FRAME_STAR: star = UniverseStar(); break;
+      case FRAME_PLANET: planet = UniversePlanet(); break;
+      default: break;
+    }
+    frames.push_back(Frame{type, ""});
+    return true;
+  }
+
+  bool end_object() override {
+    int type = frames.back().type;
+    frames.pop_back();
+    switch (type) {
+      case FRAME_GALAXY:
+        galaxy.setGalaxySeed(galaxy.galaxySeed);
+        break;
+      case FRAME_PLANET:
+        star.planets[planet.seed] = std::move(planet);
+        break;
+      case FRAME_STAR:
+        system.stars[star.seed] = std::move(star);
+        break;
+      case FRAME_SYSTEM:
+        if (decideSystem(true)==ACCEPTED) {
+          if (systemDocuments) {
+            galaxy.sectors[sectorKeyOf(sectorPosition)].systemSeeds.push_back(system.seed);
+          }
+          galaxy.systems[system.seed] = std::move(system);
+          systemsLoaded++;
+        } else {
+          systemsSkipped++;
+        }
+        break;
+      default: break;
+    }
+    return true;
+  }
+
+  bool start_array(std::size_t) override {
+    const Frame &frame = frames.back();
+    int type = FRAME_SKIP;
+    switch (frame.type) {
+      case FRAME_DOCUMENT:
+        if (frame.key=="sectors") { type = FRAME_SECTORS; }
+        if (frame.key=="systems") { type = FRAME_SYSTEMS; }
+        break;
+      case FRAME_SECTORS: type = FRAME_SECTOR_ENTRY; break;
+      case FRAME_SYSTEM:
+        if (frame.key=="stars") {
+          // skip the stars of systems outside the filter,
+          // undecided systems are decided at their end
+          type = decideSystem()==REJECTED ? FRAME_SKIP : FRAME_STARS;
+        } else {
+          type = FRAME_VALUES;
+        }
+        break;
+      case FRAME_STAR:
+        type = frame.key=="planets" ? FRAME_PLANETS : FRAME_VALUES;
+        break;
+      case FRAME_GALAXY:
+      case FRAME_SECTOR:
+      case FRAME_PLANET:
+        type = FRAME_VALUES;
+        break;
+      default: break;
+    }
+    if (type==FRAME_VALUES) {
+      values.clear();
+      integers.clear();
+    }
+    frames.push_back(Frame{type, ""});
+    return true;
+  }
+
+  bool end_array() override {
+    int type = frames.back().type;
+    frames.pop_back();
+    if (type==FRAME_VALUES) {
+      assignValues(frames.back());
+    } else if (type==FRAME_SECTOR_ENTRY) {
+      if (!filter || filter(sector)) {
+        acceptedSystems.insert(sector.systemSeeds.begin(), sector.systemSeeds.end());
+        galaxy.sectors[sectorKeyValue] = std::move(sector);
+      }
+    }
+    return true;
+  }
+
+  bool parse_error(std::size_t position, const std::string&,
+      const nlohmann::detail::exception &ex) override {
+    error = "at byte " + std::to_string(position) + ": " + ex.what();
+    return false;
   }
 
   /**
-   * Generates new planets in the system in accordance with the
-   * nebular hypothesis.
-   * Frost line (FL), where temperature is estimated to be about 150 K.
-   * Small rocky planets form inward from the FL.
-   * Larger gaseous planets form outward from the FL.
-   * Rocky elements density ~4e24 kg/au, with
-   * - min = 4e23 kg/au close to the sun (non-adhesion in melted state)
-   * - max = 9e24 (accretion in semi-melted state)
-   * - it follows a normal distribution between 0 au and the FL
-   * Gas element density decreases exponentially
-   * - from 2.5e26 at the frost line
-   * - to 3e24 at 30 au
-   * - it follows an inverse exponential function from the FL on
+   * @brief prepares the handler for the next document
    */
-  void genPlanets(uint64_t systemSeed, uint64_t starSeed) {
-    //cout << "       generating planets : ";
-    UniverseStar &star = systems[systemSeed].stars[starSeed];
-    // set generator to star
-    rng.seed(starSeed);
+  void reset() {
+    frames.assign(1, Frame{FRAME_ROOT, ""});
+    error.clear();
+  }
+
+private:
+
+  enum FRAME {
+    FRAME_ROOT, FRAME_DOCUMENT, FRAME_GALAXY, FRAME_SECTORS,
+    FRAME_SECTOR_ENTRY, FRAME_SECTOR, FRAME_SYSTEMS, FRAME_SYSTEM,
+    FRAME_STARS, FRAME_STAR, FRAME_PLANETS, FRAME_PLANET,
+    FRAME_ATMOSPHERE, FRAME_COMPOSITION, FRAME_VALUES, FRAME_SKIP
+  };
+
+  enum DECISION { UNDECIDED, ACCEPTED, REJECTED };
+
+  struct Frame {
+    int type;
+    // key of the next value (objects)
+    std::string key;
+  };
+
+  ProcUGalaxy &galaxy;
+  SectorFilter filter;
+  bool systemDocuments;
+
+  std::vector<Frame> frames{Frame{FRAME_ROOT, ""}};
+
+  // objects under construction, one per hierarchy level
+  UniverseSector sector;
+  uint64_t sectorKeyValue = 0;
+  UniverseSystem system;
+  std::vector<double> sectorPosition;
+  // deciding keys of the system read so far
+  bool seedRead = false;
+  bool sectorRead = false;
+  int accepted = UNDECIDED;
+  UniverseStar star;
+  UniversePlanet planet;
+
+  // elements of the current number array
+  // (as double and exact for uint64_t seeds)
+  std::vector<double> values;
+  std::vector<uint64_t> integers;
+
+  // systems of accepted sectors (saveGalaxy documents)
+  std::unordered_set<uint64_t> acceptedSystems;
+  // filter result per sector seed (NDJSON)
+  std::unordered_map<uint64_t, bool> sectorAccepted;
+
+  static uint64_t sectorKeyOf(const std::vector<double> &position) {
+    return sectorKey((int)position[0], (int)position[1], (int)position[2]);
+  }
+
+  /**
+   * @brief decides whether the current system is kept,
+   * once its deciding keys are read
+   * @param final - the system ended, decide with the keys read
+   */
+  int decideSystem(bool final=false) {
+    if (accepted!=UNDECIDED) { return accepted; }
+    if (!systemDocuments) {
+      // sectors precede systems in saveGalaxy documents and
+      // list their system seeds (a system may be in several)
+      if (!filter) { return accepted = ACCEPTED; }
+      if (!seedRead && !final) { return UNDECIDED; }
+      return accepted = acceptedSystems.count(system.seed) ? ACCEPTED : REJECTED;
+    }
+    // NDJSON: the sector is named by the system itself
+    if (sectorPosition.size()<3 || (!sectorRead && !final)) { return UNDECIDED; }
+    auto found = sectorAccepted.find(system.sector);
+    if (found==sectorAccepted.end()) {
+      UniverseSector lineSector;
+      lineSector.seed = system.sector;
+      lineSector.position = sectorPosition;
+      bool accept = !filter || filter(lineSector);
+      found = sectorAccepted.emplace(system.sector, accept).first;
+      if (accept && !galaxy.sectors.count(sectorKeyOf(sectorPosition))) {
+        galaxy.sectors[sectorKeyOf(sectorPosition)] = lineSector;
+      }
+    }
+    return accepted = found->second ? ACCEPTED : REJECTED;
+  }
+
+  bool number(double d, uint64_t u) {
+    Frame &frame = frames.back();
+    const std::string &k = frame.key;
+    switch (frame.type) {
+      case FRAME_GALAXY:
+        if (k=="seed") { galaxy.galaxySeed = u; }
+        else if (k=="type") { galaxy.GALAXY_TYPE = (int)d; }
+        else if (k=="sectorSize") { galaxy.SECTOR_SIZE_LY = d; }
+        else if (k=="maxSystems") { galaxy.MAX_SYSTEMS = (int)d; }
+        else if (k=="maxStars") { galaxy.MAX_STARS = (int)d; }
+        else if (k=="maxPlanets") { galaxy.MAX_PLANETS = (int)d; }
+        else if (k=="seedScheme") { galaxy.SEED_SCHEME = (int)d; }
+        else if (k=="attributeStreams") { galaxy.ATTRIBUTE_STREAMS = u!=0; }
+        else if (k=="starColorTable") { galaxy.STAR_COLOR_TABLE = u!=0; }
+        else if (k=="fastMath") { galaxy.FAST_MATH = u!=0; }
+        break;
+      case FRAME_SECTOR_ENTRY:
+        sectorKeyValue = u;
+        break;
+      case FRAME_SECTOR:
+        if (k=="seed") { sector.seed = u; }
+        break;
+      case FRAME_SYSTEM:
+        if (k=="seed") { system.seed = u; seedRead = true; }
+        else if (k=="sector") { system.sector = u; sectorRead = true; }
+        else if (k=="multiplicity") { system.multiplicity = (int)d; }
+        break;
+      case FRAME_STAR:
+        if (k=="seed") { star.seed = u; }
+        else if (k=="type") { star.typeIndex = (uint)u; }
+        else if (k=="temperatureSubclass") { star.temperatureSubclass = (int8_t)d; }
+        else if (k=="mass") { star.mass = (float)d; }
+        else if (k=="luminosity") { star.luminosity = (float)d; }
+        else if (k=="temperature") { star.temperature = (float)d; }
+        else if (k=="radius") { star.radius = (float)d; }
+        else if (k=="frostLimitAu") { star.frostLimitAu = (float)d; }
+        else if (k=="planetsCount") { star.planetsCount = (uint)u; }
+        else if (k=="axialRotation") { star.axialRotation = (float)d; }
+        break;
+      case FRAME_PLANET:
+        if (k=="seed") { planet.seed = u; }
+        else if (k=="type") { planet.typeIndex = (int)d; }
+        else if (k=="starDistance") { planet.starDistance = (float)d; }
+        else if (k=="isInHz") { planet.isInHz = u!=0; }
+        else if (k=="mass") { planet.mass = (float)d; }
+        else if (k=="mu") { planet.mu = (float)d; }
+        else if (k=="temperature") { planet.temperature = (float)d; }
+        else if (k=="equatorTemperature") { planet.equatorTemperature = (float)d; }
+        else if (k=="poleTemperature") { planet.poleTemperature = (float)d; }
+        else if (k=="radius") { planet.radius = (float)d; }
+        else if (k=="day") { planet.day = (float)d; }
+        else if (k=="year") { planet.year = (float)d; }
+        else if (k=="probTemp") { planet.probTemp = (float)d; }
+        else if (k=="probGrav") { planet.probGrav = (float)d; }
+        else if (k=="probAtmo") { planet.probAtmo = (float)d; }
+        else if (k=="rotation") { planet.rotation = (float)d; }
+        break;
+      case FRAME_ATMOSPHERE:
+        if (k=="radius") { planet.atmosphere.radius = (float)d; }
+        else if (k=="pressure") { planet.atmosphere.pressure = (float)d; }
+        break;
+      case FRAME_COMPOSITION: {
+        int gas = gasIndex(k);
+        if (gas>=0) { planet.atmosphere.composition.set(gas, (float)d); }
+        break;
+      }
+      case FRAME_VALUES:
+        values.push_back(d);
+        integers.push_back(u);
+        break;
+      default: break;
+    }
+    return true;
+  }
+
+  /**
+   * @brief stores a finished number array in the field
+   * named by the enclosing object's key
+   */
+  void assignValues(const Frame &frame) {
+    const std::string &k = frame.key;
+    switch (frame.type) {
+      case FRAME_GALAXY:
+        if (k=="size") { galaxy.GALAXY_SIZE_LY = values; }
+        break;
+      case FRAME_SECTOR:
+        if (k=="position") { sector.position = values; }
+        else if (k=="systems") { sector.systemSeeds = integers; }
+        break;
+      case FRAME_SYSTEM:
+        if (k=="position") { system.position = values; }
+        else if (k=="sectorPosition") { sectorPosition = values; }
+        break;
+      case FRAME_STAR:
+        if (k=="position") { star.position = values; }
+        else if (k=="color") { star.color.assign(integers.begin(), integers.end()); }
+        else if (k=="hzDistAu") {
+          for (size_t i=0; i<values.size() && i<8; ++i) { star.hzDistAu[i] = (float)values[i]; }
+        }
+        break;
+      case FRAME_PLANET:
+        if (k=="position") { planet.position = values; }
+        else if (k=="baseColor") { planet.baseColor.assign(integers.begin(), integers.end()); }
+        break;
+      default: break;
+    }
+  }
+
+}; // end class GalaxySaxHandler
+
+
+// encodings for Universe objects and galaxies
+
+/**
+ * Encodings of saveGalaxy, loadGalaxy and encodeObject
+**/
+enum GALAXY_FORMAT {
+    FORMAT_JSON    = 0,  // text
+    FORMAT_CBOR    = 1,  // RFC 7049
+    FORMAT_MSGPACK = 2,  // MessagePack
+    FORMAT_BSON    = 3   // seeds as bit-cast signed 64-bit
+};
+
+/**
+ * @brief format from its name ("json", "cbor", "msgpack", "bson")
+ * @return GALAXY_FORMAT, or -1 if unknown
+ */
+int galaxyFormat(const std::string &name) {
+  if (name=="json") { return FORMAT_JSON; }
+  if (name=="cbor") { return FORMAT_CBOR; }
+  if (name=="msgpack") { return FORMAT_MSGPACK; }
+  if (name=="bson") { return FORMAT_BSON; }
+  return -1;
+}
+
+/**
+ * @brief name of a GALAXY_FORMAT
+ */
+std::string galaxyFormatName(const int format) {
+  switch (format) {
+    case FORMAT_CBOR: return "cbor";
+    case FORMAT_MSGPACK: return "msgpack";
+    case FORMAT_BSON: return "bson";
+    default: return "json";
+  }
+}
+
+/**
+ * @brief replaces unsigned integers from 2^63 on (seeds) by
+ * their bit-cast signed value, since BSON has no unsigned
+ * integers; get<uint64_t> and GalaxySaxHandler cast them back
+ */
+void toBsonIntegers(json &j) {
+  if (j.is_number_unsigned()) {
+    uint64_t value = j.get<uint64_t>();
+    if (value>(uint64_t)std::numeric_limits<int64_t>::max()) { j = (int64_t)value; }
+  } else if (j.is_structured()) {
+    for (json &element : j) { toBsonIntegers(element); }
+  }
+}
 
-    // get planet seeds for this system
-    vector<uint64_t> planetSeeds = getPlanetSeeds(starSeed, star.planetsCount);
+/**
+ * @brief writes a json value in the given format
+ * (BSON only accepts objects)
+ */
+void writeEncoded(std::ostream &out, const json &j, const int format) {
+  switch (format) {
+    case FORMAT_CBOR: json::to_cbor(j, out); break;
+    case FORMAT_MSGPACK: json::to_msgpack(j, out); break;
+    case FORMAT_BSON: {
+      json signedJ = j;
+      toBsonIntegers(signedJ);
+      json::to_bson(signedJ, out);
+      break;
+    }
+    default: out << j.dump(); break;
+  }
+}
 
-    // init data for random planet position within the frost limit
-    // TODO: how to assure that not too many small planets are generated?
-    float lowerLimitAu = 0;
-    //float upperLimitAu = 0;
-    float planetDistanceAu = 0.0f;
+/**
+ * @brief writes a CBOR or MessagePack map or array header
+ * with a 32-bit item count; the items follow encoded one
+ * by one, so large containers are streamed
+ */
+void writeBinaryContainer(std::ostream &out, const int format, const bool isMap, const uint32_t size) {
+  uint8_t tag = format==FORMAT_CBOR ? (isMap ? 0xBA : 0x9A) : (isMap ? 0xDF : 0xDD);
+  char header[5] = {(char)tag, (char)(size>>24), (char)(size>>16), (char)(size>>8), (char)size};
+  out.write(header, sizeof(header));
+}
 
-    // generate all the planets for the star
-    for(int i=0; i<(int)star.planetsCount; ++i) {
+/**
+ * @brief Encodes a universe object (planet, star, system,
+ * sector) through its to_json serializer.
+ * @param object - object to encode
+ * @param format - GALAXY_FORMAT
+ * @return encoded bytes (text for FORMAT_JSON)
+ */
+template <class T>
+std::vector<uint8_t> encodeObject(const T &object, const int format=FORMAT_CBOR) {
+  json j = object;
+  switch (format) {
+    case FORMAT_CBOR: return json::to_cbor(j);
+    case FORMAT_MSGPACK: return json::to_msgpack(j);
+    case FORMAT_BSON: toBsonIntegers(j); return json::to_bson(j);
+    default: {
+      std::string text = j.dump();
+      return std::vector<uint8_t>(text.begin(), text.end());
+    }
+  }
+}
 
-      // randomized planet distance from the star
-      if (lowerLimitAu<star.frostLimitAu) {
-          // inward of the frost limit
-          planetDistanceAu = lowerLimitAu + 0.1f + rng.nextFloat() * (star.frostLimitAu - lowerLimitAu);
-      } else  {
-          // outward of the frost limit
-          // max distance between planets
-          // TODO: take into expression the possible system size based on the star mass
-          planetDistanceAu *= 1.5f + rng.nextFloat();
-          if (planetDistanceAu<=lowerLimitAu) {
-              planetDistanceAu += lowerLimitAu;
-          }
-      }
+/**
+ * @brief Decodes a universe object written by encodeObject
+ * through its from_json deserializer.
+ * Throws json::exception on malformed input.
+ */
+template <class T>
+T decodeObject(const std::vector<uint8_t> &data, const int format=FORMAT_CBOR) {
+  switch (format) {
+    case FORMAT_CBOR: return json::from_cbor(data).get<T>();
+    case FORMAT_MSGPACK: return json::from_msgpack(data).get<T>();
+    case FORMAT_BSON: return json::from_bson(data).get<T>();
+    default: return json::parse(data.begin(), data.end()).get<T>();
+  }
+}
 
-      // refactored planet generation
-      // generate the planet data
-      UniversePlanet planet = genPlanet(planetSeeds[i], star, planetDistanceAu, lowerLimitAu);
 
-      // finally add the planet to the star at the end
-      // since it will be a copy of the local planet object
-      systems[systemSeed].stars[starSeed].planets[planetSeeds[i]] = planet;
+// save/load functions for Universe Galaxy
 
-      // update star record in system
-      //systems[systemSeed].stars[starSeed] = star;
+/**
+ * @brief Serializes and saves the galaxy configuration,
+ * sectors and generated systems with their stars, planets
+ * and atmospheres. Sectors and systems are encoded one at
+ * a time (one per line for FORMAT_JSON), so no document of
+ * the whole galaxy is built, except for FORMAT_BSON whose
+ * documents start with their byte length; that document is
+ * encoded before the file is opened, so a failure leaves no
+ * truncated file. BSON has no unsigned integers, seeds from
+ * 2^63 on (SEED_HASHED) are stored bit-cast to int64.
+ * @param galaxy - galaxy to save
+ * @param filename - output file
+ * @param format - GALAXY_FORMAT
+ * @return true if written
+ */
+bool saveGalaxy(const ProcUGalaxy &galaxy, const std::string &filename="galaxy.json", const int format=FORMAT_JSON) {
+  json jGalaxy = {
+    {"seed", galaxy.galaxySeed},
+    {"type", galaxy.GALAXY_TYPE},
+    {"size", galaxy.GALAXY_SIZE_LY},
+    {"sectorSize", galaxy.SECTOR_SIZE_LY},
+    {"maxSystems", galaxy.MAX_SYSTEMS},
+    {"maxStars", galaxy.MAX_STARS},
+    {"maxPlanets", galaxy.MAX_PLANETS},
+    {"seedScheme", galaxy.SEED_SCHEME},
+    {"attributeStreams", galaxy.ATTRIBUTE_STREAMS},
+    {"starColorTable", galaxy.STAR_COLOR_TABLE},
+    {"fastMath", galaxy.FAST_MATH}
+  };
+
+  if (format==FORMAT_BSON) {
+    json data = {{"galaxy", jGalaxy}, {"sectors", galaxy.sectors}, {"systems", json::array()}};
+    json &jSystems = data["systems"];
+    for (auto& [systemSeed, system] : galaxy.systems) {
+      jSystems.push_back(system);
+    }
+    toBsonIntegers(data);
+    std::vector<uint8_t> bytes;
+    try {
+      bytes = json::to_bson(data);
+    } catch (json::exception&) {
+      return false;
+    }
+    std::ofstream outFile(filename, std::ios::binary);
+    outFile.write((const char*)bytes.data(), bytes.size());
+    return (bool)outFile;
+  }
 
-    } // loop planet
-    //cout << "DEBUG: planets in system = " << star.planets.size() << "\n";
+  std::ofstream outFile(filename, std::ios::binary);
+  if (!outFile) { return false; }
+
+  if (format==FORMAT_CBOR || format==FORMAT_MSGPACK) {
+    writeBinaryContainer(outFile, format, true, 3);
+    writeEncoded(outFile, "galaxy", format);
+    writeEncoded(outFile, jGalaxy, format);
+    writeEncoded(outFile, "sectors", format);
+    writeBinaryContainer(outFile, format, false, (uint32_t)galaxy.sectors.size());
+    for (auto& [key, sector] : galaxy.sectors) {
+      writeEncoded(outFile, json{key, sector}, format);
+    }
+    writeEncoded(outFile, "systems", format);
+    writeBinaryContainer(outFile, format, false, (uint32_t)galaxy.systems.size());
+    for (auto& [systemSeed, system] : galaxy.systems) {
+      writeEncoded(outFile, system, format);
+    }
+    return (bool)outFile;
+  }
 
-  } // end genPlanets function
+  outFile << "{\n\"galaxy\": " << jGalaxy.dump() << ",\n\"sectors\": [";
+  const char *separator = "\n";
+  for (auto& [key, sector] : galaxy.sectors) {
+    outFile << separator << json{key, sector}.dump();
+    separator = ",\n";
+  }
+  outFile << "\n],\n\"systems\": [";
+  separator = "\n";
+  for (auto& [systemSeed, system] : galaxy.systems) {
+    outFile << separator << json(system).dump();
+    separator = ",\n";
+  }
+  outFile << "\n]\n}\n";
+  return (bool)outFile;
+}
 
-}; // end class ProcUGalaxy
+/**
+ * @brief Loads a galaxy saved with saveGalaxy, streaming
+ * the file through GalaxySaxHandler in any GALAXY_FORMAT.
+ * Replaces sectors and systems of the galaxy; with a filter
+ * only the accepted sectors and their systems are
+ * materialized. Files holding only the galaxy seed load
+ * as before.
+ * @param galaxy - galaxy to restore
+ * @param filename - input file
+ * @param filter - sector selection, empty loads all
+ * @param format - GALAXY_FORMAT the file was saved in
+ * @return true if the file was parsed completely
+ */
+bool loadGalaxy(ProcUGalaxy &galaxy, const std::string &filename="galaxy.json",
+    const SectorFilter &filter=nullptr, const int format=FORMAT_JSON) {
+  std::ifstream inFile(filename, std::ios::binary);
+  if (!inFile) { return false; }
+
+  json::input_format_t inputFormat = json::input_format_t::json;
+  switch (format) {
+    case FORMAT_CBOR: inputFormat = json::input_format_t::cbor; break;
+    case FORMAT_MSGPACK: inputFormat = json::input_format_t::msgpack; break;
+    case FORMAT_BSON: inputFormat = json::input_format_t::bson; break;
+    default: break;
+  }
+  galaxy.sectors.clear();
+  galaxy.systems.clear();
+  GalaxySaxHandler handler(galaxy, filter);
+  return json::sax_parse(inFile, &handler, inputFormat);
+}
+
+/**
+ * @brief Streams the systems of a sector region as
+ * newline delimited JSON (NDJSON), one complete system
+ * with its stars and planets per line.
+ * Each system is generated, written and released before
+ * the next one, so memory does not grow with the region.
+ * Lines carry the sector coordinate as "sectorPosition"
+ * next to the system fields of to_json.
+ * @param galaxy - generator configuration and seed
+ * @param region - sectors to export, clipped to the galaxy
+ * @param out - output stream
+ * @return number of systems written, or -1 if the stream
+ *   failed (the export stops at the first failed line)
+ */
+long exportRegionNdjson(const ProcUGalaxy &galaxy, const SectorRegion &region, std::ostream &out) {
+  if (!out) { return -1; }
+  long count = 0;
+  for (SectorCoordinate sector : galaxy.sectorRange(region)) {
+    for (uint64_t systemSeed : galaxy.getSystemSeeds(sector.seed)) {
+      UniverseSystem system = galaxy.genSystemComplete(systemSeed);
+      system.sector = sector.seed;
+      json line = system;
+      line["sectorPosition"] = {sector.x, sector.y, sector.z};
+      out << line.dump() << '\n';
+      if (!out) { return -1; }
+      count++;
+    }
+  }
+  out.flush();
+  return out ? count : -1;
+}
+
+/**
+ * @brief Streams the systems of a sector region to
+ * an NDJSON file (see exportRegionNdjson).
+ * @return number of systems written, or -1 if the file
+ *   could not be written
+ */
+long exportRegionNdjson(const ProcUGalaxy &galaxy, const SectorRegion &region, const std::string &filename) {
+  std::ofstream outFile(filename);
+  if (!outFile) { return -1; }
+  return exportRegionNdjson(galaxy, region, outFile);
+}
+
+/**
+ * @brief Loads systems exported with exportRegionNdjson,
+ * streaming each line through GalaxySaxHandler.
+ * Systems are added to the galaxy and registered in their
+ * sectors (rebuilt from "sectorPosition"), so several
+ * region files can be merged into one galaxy.
+ * @param galaxy - galaxy to fill
+ * @param filename - NDJSON input file
+ * @param filter - sector selection, empty loads all
+ * @return number of systems loaded, or -1 on a parse error
+ */
+long loadRegionNdjson(ProcUGalaxy &galaxy, const std::string &filename, const SectorFilter &filter=nullptr) {
+  std::ifstream inFile(filename, std::ios::binary);
+  if (!inFile) { return -1; }
+
+  GalaxySaxHandler handler(galaxy, filter, true);
+  std::string line;
+  while (std::getline(inFile, line)) {
+    if (line.empty()) { continue; }
+    handler.reset();
+    if (!json::sax_parse(line, &handler)) { return -1; }
+  }
+  return (long)handler.systemsLoaded;
+}
 
 
 //-----------------------------------
-// libProcU Universe serialization
+// libProcU binary snapshot
 //-----------------------------------
 
 /**
- * @brief Universe serialization must define
- * to_json and from_json functions for all
- * universe data structures.
- * TODO: extend with serialization for system objects.
- */
+ * Binary columnar snapshot of a UniverseStore.
+ * Layout (native little endian):
+ * - SnapshotHeader (64 bytes)
+ * - SnapshotColumn directory, one entry per column (64 bytes each)
+ * - column blocks, each aligned to SNAPSHOT_ALIGNMENT
+ * Columns are named after the UniverseStore members.
+ * System positions are quantized to uint32 steps of
+ * positionScale [ly] within the sector; parent indices
+ * (starSystem, planetStar) replace the offset columns.
+ * Readers skip unknown columns and zero missing ones
+ * (except the seed columns, which give the row counts),
+ * so columns can be added without a version change.
+**/
 
-// de-/serializer for Universe Planet
+const char SNAPSHOT_MAGIC[8] = {'P','R','O','C','U','G','S','\0'};
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint64_t SNAPSHOT_ALIGNMENT = 64;
+
+// object level of a snapshot column
+enum SNAPSHOT_LEVEL {
+    SNAPSHOT_SYSTEM = 0,
+    SNAPSHOT_STAR   = 1,
+    SNAPSHOT_PLANET = 2,
+    SNAPSHOT_INDEX  = 3   // catalog index, own length
+};
+
+// value type of a snapshot column
+enum SNAPSHOT_TYPE {
+    SNAPSHOT_U8  = 0,
+    SNAPSHOT_I8  = 1,
+    SNAPSHOT_U16 = 2,
+    SNAPSHOT_U32 = 3,
+    SNAPSHOT_U64 = 4,
+    SNAPSHOT_F32 = 5,
+    SNAPSHOT_F64 = 6
+};
 
 /**
- * @brief JSON serializer for universe star
+ * @brief Snapshot file header.
  */
-void to_json(json& j, const UniversePlanet& planet) {
-    j = json{
-      {"seed", planet.seed},
-      {"type", planet.typeIndex},
-      {"mass", planet.mass},
-      {"temperature", planet.temperature}
-    };
-}
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version = SNAPSHOT_VERSION;
+  uint32_t columnCount = 0;
+  uint64_t galaxySeed = 0;
+  // systems, stars, planets (see SNAPSHOT_LEVEL)
+  uint64_t count[3] = {0, 0, 0};
+  // system position step in [ly]
+  double positionScale = 0.0;
+  uint64_t reserved = 0;
+};
 
 /**
- * @brief JSON deserializer for universe star
+ * @brief Snapshot directory entry of a column block.
  */
-void from_json(const json& j, UniversePlanet& planet) {
-    j.at("seed").get_to(planet.name);
-    j.at("type").get_to(planet.typeIndex);
-    j.at("mass").get_to(planet.mass);
-    j.at("temperature").get_to(planet.temperature);
-}
+struct SnapshotColumn {
+  char name[32];
+  uint32_t level = SNAPSHOT_SYSTEM;
+  uint32_t type = SNAPSHOT_U8;
+  // values per object
+  uint32_t width = 1;
+  uint32_t reserved = 0;
+  // block position from the file start, and size
+  uint64_t offset = 0;
+  uint64_t bytes = 0;
+};
 
-// de-/serializer for Universe Star
+static_assert(sizeof(SnapshotHeader)==64, "snapshot header must be 64 bytes");
+static_assert(sizeof(SnapshotColumn)==64, "snapshot column entry must be 64 bytes");
+
+// snapshot type of a column value
+template <class T> uint32_t snapshotType();
+template <> uint32_t snapshotType<uint8_t>() { return SNAPSHOT_U8; }
+template <> uint32_t snapshotType<int8_t>() { return SNAPSHOT_I8; }
+template <> uint32_t snapshotType<uint16_t>() { return SNAPSHOT_U16; }
+template <> uint32_t snapshotType<uint32_t>() { return SNAPSHOT_U32; }
+template <> uint32_t snapshotType<uint64_t>() { return SNAPSHOT_U64; }
+template <> uint32_t snapshotType<float>() { return SNAPSHOT_F32; }
+template <> uint32_t snapshotType<double>() { return SNAPSHOT_F64; }
 
 /**
- * @brief JSON serializer for universe star
+ * @brief Calls visit(name, level, width, column) for every
+ * snapshot column of a store, in file order.
+ * Quantized system positions are passed separately.
  */
-void to_json(json& j, const UniverseStar& star) {
-    j = json{{"seed", star.seed}, {"type", star.typeIndex}, {"mass", star.mass}};
+template <class Store, class Position, class Visitor>
+void visitSnapshotColumns(Store &store, Position &x, Position &y, Position &z, Visitor visit) {
+  const int slots = UniverseStore::COMPOSITION_SLOTS;
+  visit("systemSeed", SNAPSHOT_SYSTEM, 1, store.systemSeed);
+  visit("systemSector", SNAPSHOT_SYSTEM, 1, store.systemSector);
+  visit("systemX", SNAPSHOT_SYSTEM, 1, x);
+  visit("systemY", SNAPSHOT_SYSTEM, 1, y);
+  visit("systemZ", SNAPSHOT_SYSTEM, 1, z);
+  visit("systemMultiplicity", SNAPSHOT_SYSTEM, 1, store.systemMultiplicity);
+  visit("starSeed", SNAPSHOT_STAR, 1, store.starSeed);
+  visit("starSystem", SNAPSHOT_STAR, 1, store.starSystem);
+  visit("starTypeIndex", SNAPSHOT_STAR, 1, store.starTypeIndex);
+  visit("starTemperatureSubclass", SNAPSHOT_STAR, 1, store.starTemperatureSubclass);
+  visit("starMass", SNAPSHOT_STAR, 1, store.starMass);
+  visit("starLuminosity", SNAPSHOT_STAR, 1, store.starLuminosity);
+  visit("starTemperature", SNAPSHOT_STAR, 1, store.starTemperature);
+  visit("starRadius", SNAPSHOT_STAR, 1, store.starRadius);
+  visit("starColor", SNAPSHOT_STAR, 3, store.starColor);
+  visit("starHzDistAu", SNAPSHOT_STAR, 8, store.starHzDistAu);
+  visit("starFrostLimitAu", SNAPSHOT_STAR, 1, store.starFrostLimitAu);
+  visit("starAxialRotation", SNAPSHOT_STAR, 1, store.starAxialRotation);
+  visit("planetSeed", SNAPSHOT_PLANET, 1, store.planetSeed);
+  visit("planetStar", SNAPSHOT_PLANET, 1, store.planetStar);
+  visit("planetStarDistance", SNAPSHOT_PLANET, 1, store.planetStarDistance);
+  visit("planetIsInHz", SNAPSHOT_PLANET, 1, store.planetIsInHz);
+  visit("planetTypeIndex", SNAPSHOT_PLANET, 1, store.planetTypeIndex);
+  visit("planetMass", SNAPSHOT_PLANET, 1, store.planetMass);
+  visit("planetMu", SNAPSHOT_PLANET, 1, store.planetMu);
+  visit("planetTemperature", SNAPSHOT_PLANET, 1, store.planetTemperature);
+  visit("planetEquatorTemperature", SNAPSHOT_PLANET, 1, store.planetEquatorTemperature);
+  visit("planetPoleTemperature", SNAPSHOT_PLANET, 1, store.planetPoleTemperature);
+  visit("planetRadius", SNAPSHOT_PLANET, 1, store.planetRadius);
+  visit("planetDay", SNAPSHOT_PLANET, 1, store.planetDay);
+  visit("planetYear", SNAPSHOT_PLANET, 1, store.planetYear);
+  visit("planetProbTemp", SNAPSHOT_PLANET, 1, store.planetProbTemp);
+  visit("planetProbGrav", SNAPSHOT_PLANET, 1, store.planetProbGrav);
+  visit("planetProbAtmo", SNAPSHOT_PLANET, 1, store.planetProbAtmo);
+  visit("atmosphereRadius", SNAPSHOT_PLANET, 1, store.atmosphereRadius);
+  visit("atmospherePressure", SNAPSHOT_PLANET, 1, store.atmospherePressure);
+  visit("atmosphereComposition", SNAPSHOT_PLANET, slots, store.atmosphereComposition);
+  visit("atmosphereElements", SNAPSHOT_PLANET, 1, store.atmosphereElements);
+}
 
-    // serialize planets
-    json jPlanet;
-    for (auto& [planetSeed, planet] : star.planets) {
-      jPlanet.push_back(planet);
-    }
-    if (star.planetsCount>0) {
-      j["planets"] = jPlanet;
+/**
+ * @brief Saves a store as binary columnar snapshot
+ * followed by extra columns.
+ * @param extraColumns - called with a visitor taking
+ *   (name, level, width, column) for each extra column
+ * (see saveSnapshot)
+ */
+template <class Extra>
+bool saveSnapshotColumns(const UniverseStore &store, const std::string &filename, uint64_t galaxySeed, double sectorSizeLy, Extra extraColumns) {
+  SnapshotHeader header;
+  std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+  header.galaxySeed = galaxySeed;
+  header.count[SNAPSHOT_SYSTEM] = store.systemCount();
+  header.count[SNAPSHOT_STAR] = store.starCount();
+  header.count[SNAPSHOT_PLANET] = store.planetCount();
+  header.positionScale = sectorSizeLy / 4294967296.0;
+
+  // quantize system positions within the sector
+  auto quantize = [&](const std::vector<double> &position) {
+    std::vector<uint32_t> steps(position.size());
+    for (size_t i=0; i<position.size(); ++i) {
+      double step = std::round(position[i] / header.positionScale);
+      steps[i] = (uint32_t)std::min(std::max(step, 0.0), 4294967295.0);
     }
+    return steps;
+  };
+  std::vector<uint32_t> x = quantize(store.systemX);
+  std::vector<uint32_t> y = quantize(store.systemY);
+  std::vector<uint32_t> z = quantize(store.systemZ);
+
+  // directory with aligned block offsets
+  std::vector<SnapshotColumn> columns;
+  std::vector<const char*> blocks;
+  auto addColumn = [&](const char *name, int level, int width, auto &column) {
+    SnapshotColumn entry;
+    std::memset(entry.name, 0, sizeof(entry.name));
+    std::strncpy(entry.name, name, sizeof(entry.name)-1);
+    entry.level = level;
+    entry.type = snapshotType<typename std::decay_t<decltype(column)>::value_type>();
+    entry.width = width;
+    entry.bytes = column.size() * sizeof(column[0]);
+    columns.push_back(entry);
+    blocks.push_back((const char*)column.data());
+  };
+  visitSnapshotColumns(store, x, y, z, addColumn);
+  extraColumns(addColumn);
+  header.columnCount = (uint32_t)columns.size();
+  uint64_t offset = sizeof(SnapshotHeader) + columns.size()*sizeof(SnapshotColumn);
+  for (SnapshotColumn &entry : columns) {
+    offset = (offset + SNAPSHOT_ALIGNMENT-1) / SNAPSHOT_ALIGNMENT * SNAPSHOT_ALIGNMENT;
+    entry.offset = offset;
+    offset += entry.bytes;
+  }
+
+  std::ofstream out(filename, std::ios::binary);
+  out.write((const char*)&header, sizeof(header));
+  out.write((const char*)columns.data(), columns.size()*sizeof(SnapshotColumn));
+  const char padding[SNAPSHOT_ALIGNMENT] = {0};
+  for (size_t c=0; c<columns.size(); ++c) {
+    out.write(padding, columns[c].offset - (uint64_t)out.tellp());
+    out.write(blocks[c], columns[c].bytes);
+  }
+  return (bool)out;
 }
 
 /**
- * @brief JSON deserializer for universe star
+ * @brief Saves a store as binary columnar snapshot.
+ * @param store - objects to save
+ * @param filename - snapshot file
+ * @param galaxySeed - recorded in the header
+ * @param sectorSizeLy - sector edge length, sets the
+ *   system position quantization (sectorSizeLy / 2^32)
+ * @return false if the file could not be written
  */
-void from_json(const json& j, UniverseStar& star) {
-    j.at("seed").get_to(star.name);
-    j.at("type").get_to(star.typeIndex);
-    j.at("mass").get_to(star.mass);
+bool saveSnapshot(const UniverseStore &store, const std::string &filename, uint64_t galaxySeed=0, double sectorSizeLy=10.0) {
+  return saveSnapshotColumns(store, filename, galaxySeed, sectorSizeLy, [](auto&) {});
 }
 
-// de-/serializer for Universe System
+/**
+ * @brief Saves a store as binary columnar snapshot with
+ * the galaxy seed and sector size of the generator.
+ */
+bool saveSnapshot(const ProcUGalaxy &galaxy, const UniverseStore &store, const std::string &filename) {
+  return saveSnapshot(store, filename, galaxy.galaxySeed, galaxy.SECTOR_SIZE_LY);
+}
 
 /**
- * @brief JSON serializer for universe system
+ * @brief Reads the header and column directory of a snapshot.
+ * @return false if the file is no snapshot of a known version,
+ *   or the directory or a block lies outside the file
  */
-void to_json(json& j, const UniverseSystem& system) {
-    //j = json{{"stars", system.stars}}; // cannot serialize maps directly
-    j = json{{"sector", system.sector}, {"seed", system.seed}, {"position", system.position},
-      {"multiplicity", system.multiplicity}};
+bool readSnapshotDirectory(std::istream &in, SnapshotHeader &header, std::vector<SnapshotColumn> &columns) {
+  in.seekg(0, std::ios::end);
+  const uint64_t fileSize = (uint64_t)in.tellg();
+  in.seekg(0);
+  in.read((char*)&header, sizeof(header));
+  if (!in || std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic))!=0
+    || header.version>SNAPSHOT_VERSION
+    || header.columnCount > (fileSize-sizeof(header)) / sizeof(SnapshotColumn)) {
+    return false;
+  }
+  columns.resize(header.columnCount);
+  in.read((char*)columns.data(), columns.size()*sizeof(SnapshotColumn));
+  for (const SnapshotColumn &entry : columns) {
+    if (entry.offset>fileSize || entry.bytes>fileSize-entry.offset) { return false; }
+  }
+  return (bool)in;
+}
 
-    // The following insert a duplicated key record
-    // which is the star seed... We keep it for archival purpose
-    //json jStars(system.stars);
-    //j["stars"] = jStars;
+/**
+ * @brief Reads the block of a directory entry into a column.
+ * @return false on a type mismatch or read error
+ */
+template <class T>
+bool readSnapshotBlock(std::istream &in, const SnapshotColumn &entry, std::vector<T> &column) {
+  if (entry.type!=snapshotType<T>() || entry.bytes%sizeof(T)!=0) {
+    return false;
+  }
+  column.resize(entry.bytes / sizeof(T));
+  in.seekg(entry.offset);
+  in.read((char*)column.data(), entry.bytes);
+  return (bool)in;
+}
 
-    // Therefore we prefer this iterative method
-    json jStar;
-    for (auto& [starSeed, star] : system.stars) {
-      jStar.push_back(star);
+/**
+ * @brief Reads a single column of a snapshot by name
+ * (see visitSnapshotColumns), without reading the others.
+ * @return false if the column is missing or has another type
+ */
+template <class T>
+bool readSnapshotColumn(const std::string &filename, const std::string &name, std::vector<T> &column) {
+  std::ifstream in(filename, std::ios::binary);
+  SnapshotHeader header;
+  std::vector<SnapshotColumn> columns;
+  if (!readSnapshotDirectory(in, header, columns)) {
+    return false;
+  }
+  for (const SnapshotColumn &entry : columns) {
+    if (name==entry.name) {
+      return readSnapshotBlock(in, entry, column);
     }
-    j["stars"] = jStar;
+  }
+  return false;
 }
 
 /**
- * @brief JSON deserializer for universe system
+ * @brief Checks that parent indices address existing rows
+ * and are grouped (non-decreasing), as the offset columns
+ * of restoreSnapshotStore require.
  */
-void from_json(const json& j, UniverseSystem& system) {
-    j.at("seed").get_to(system.seed);
-    j.at("position").get_to(system.position);
-    //j.at("stars").get_to(system.stars);
+bool validParentIndices(const std::vector<uint32_t> &parents, const size_t parentCount) {
+  uint32_t previous = 0;
+  for (uint32_t parent : parents) {
+    if (parent>=parentCount || parent<previous) { return false; }
+    previous = parent;
+  }
+  return true;
 }
 
-// de-/serializer for Universe Sector
-
 /**
- * @brief JSON serializer for universe sector
+ * @brief Restores the columns of a store read from a snapshot:
+ * positions from their quantized steps, and the offset
+ * columns from the parent indices.
+ * @return false if starSystem or planetStar are no valid
+ *   parent indices (see validParentIndices)
  */
-void to_json(json& j, const UniverseSector& sector) {
-    j = json{{"seed", sector.seed}, {"position", sector.position},
-      {"name", sector.name}, {"systems", sector.systemSeeds}};
+bool restoreSnapshotStore(UniverseStore &store, const std::vector<uint32_t> &x,
+  const std::vector<uint32_t> &y, const std::vector<uint32_t> &z, double positionScale) {
+  if (!validParentIndices(store.starSystem, store.systemCount())
+    || !validParentIndices(store.planetStar, store.starCount())) {
+    return false;
+  }
+  store.systemX.resize(x.size());
+  store.systemY.resize(y.size());
+  store.systemZ.resize(z.size());
+  for (size_t i=0; i<x.size(); ++i) {
+    store.systemX[i] = x[i] * positionScale;
+    store.systemY[i] = y[i] * positionScale;
+    store.systemZ[i] = z[i] * positionScale;
+  }
+  store.systemStarOffset.assign(store.systemCount()+1, 0);
+  for (uint32_t system : store.starSystem) {
+    store.systemStarOffset[system+1]++;
+  }
+  std::partial_sum(store.systemStarOffset.begin(), store.systemStarOffset.end(), store.systemStarOffset.begin());
+  store.starPlanetOffset.assign(store.starCount()+1, 0);
+  for (uint32_t star : store.planetStar) {
+    store.starPlanetOffset[star+1]++;
+  }
+  std::partial_sum(store.starPlanetOffset.begin(), store.starPlanetOffset.end(), store.starPlanetOffset.begin());
+  return true;
 }
 
 /**
- * @brief JSON deserializer for universe sector
+ * @brief Loads a binary columnar snapshot into a store,
+ * replacing its content.
+ * The seed columns must be present; every block must hold
+ * count*width values of its level, which bounds the counts
+ * of the header by the file size.
+ * @param galaxySeed - set to the recorded galaxy seed if given
+ * @return false (with an empty store) if the file is no
+ *   valid snapshot
  */
-void from_json(const json& j, UniverseSector& sector) {
-    j.at("seed").get_to(sector.seed);
+bool loadSnapshot(UniverseStore &store, const std::string &filename, uint64_t *galaxySeed=nullptr) {
+  std::ifstream in(filename, std::ios::binary);
+  SnapshotHeader header;
+  std::vector<SnapshotColumn> columns;
+  store.clear();
+  if (!readSnapshotDirectory(in, header, columns)) {
+    return false;
+  }
+
+  // the seed columns bound the counts by the file size
+  const char *seedNames[] = {"systemSeed", "starSeed", "planetSeed"};
+  for (int level = SNAPSHOT_SYSTEM; level<=SNAPSHOT_PLANET; level++) {
+    bool found = false;
+    for (const SnapshotColumn &entry : columns) {
+      found |= std::strncmp(seedNames[level], entry.name, sizeof(entry.name))==0
+        && entry.bytes%sizeof(uint64_t)==0 && entry.bytes/sizeof(uint64_t)==header.count[level];
+    }
+    if (!found) { return false; }
+  }
+
+  bool valid = true;
+  std::vector<uint32_t> x, y, z;
+  visitSnapshotColumns(store, x, y, z, [&](const char *name, int level, int width, auto &column) {
+    using T = typename std::decay_t<decltype(column)>::value_type;
+    const uint64_t values = header.count[level] * width;
+    for (const SnapshotColumn &entry : columns) {
+      if (std::strncmp(name, entry.name, sizeof(entry.name))==0) {
+        valid &= entry.bytes==values*sizeof(T) && readSnapshotBlock(in, entry, column);
+      }
+    }
+    // missing columns are zero
+    column.resize(values);
+  });
+  if (!valid || !restoreSnapshotStore(store, x, y, z, header.positionScale)) {
+    store.clear();
+    return false;
+  }
+
+  if (galaxySeed) {
+    *galaxySeed = header.galaxySeed;
+  }
+  return true;
 }
 
-// save/load functions for Universe Sector
+
+//-----------------------------------
+// libProcU procu::ProcUCatalog
+//-----------------------------------
 
 /**
- * @brief Serializes and saves universe data
- * TODO: add filename as param
- * TODO: add other objects
+ * @brief Bakes the systems of a sector region into a
+ * read-only catalog file for ProcUCatalog.
+ * A catalog is a snapshot (see saveSnapshot) with the columns
+ * - systemStarOffset, starPlanetOffset (object ranges)
+ * - indexSystemSeed, indexSystemRow (sorted system seeds)
+ * - indexSectorKey, indexSectorFirst, indexSectorCount
+ *   (sorted sector keys with their system rows)
+ * Sectors are generated in Z-order (sectorKey), so the systems
+ * of neighboring sectors are stored together.
+ * The region is held in memory while baking.
+ * @return false if the file could not be written
  */
-void saveGalaxy(ProcUGalaxy &galaxy) {
-  json data;
+bool bakeCatalog(const ProcUGalaxy &galaxy, const SectorRegion &region, const std::string &filename) {
+  std::vector<std::pair<uint64_t, SectorCoordinate>> sectors;
+  for (SectorCoordinate sector : galaxy.sectorRange(region)) {
+    sectors.emplace_back(sectorKey(sector.x, sector.y, sector.z), sector);
+  }
+  std::sort(sectors.begin(), sectors.end(),
+    [](const auto &a, const auto &b) { return a.first < b.first; });
+
+  UniverseStore store;
+  std::vector<uint64_t> indexSectorKey;
+  std::vector<uint32_t> indexSectorFirst, indexSectorCount;
+  for (auto& [key, sector] : sectors) {
+    uint32_t first = (uint32_t)store.systemCount();
+    for (uint64_t systemSeed : galaxy.getSystemSeeds(sector.seed)) {
+      UniverseSystem system = galaxy.genSystemComplete(systemSeed);
+      system.sector = sector.seed;
+      store.append(system);
+    }
+    indexSectorKey.push_back(key);
+    indexSectorFirst.push_back(first);
+    indexSectorCount.push_back((uint32_t)store.systemCount() - first);
+  }
 
-  // serialize from object to json
-  data["galaxy"]["seed"] = galaxy.galaxySeed;
+  // system rows ordered by seed
+  std::vector<uint32_t> indexSystemRow(store.systemCount());
+  std::iota(indexSystemRow.begin(), indexSystemRow.end(), 0);
+  std::stable_sort(indexSystemRow.begin(), indexSystemRow.end(),
+    [&](uint32_t a, uint32_t b) { return store.systemSeed[a] < store.systemSeed[b]; });
+  std::vector<uint64_t> indexSystemSeed(indexSystemRow.size());
+  for (size_t i=0; i<indexSystemRow.size(); ++i) {
+    indexSystemSeed[i] = store.systemSeed[indexSystemRow[i]];
+  }
 
-  // write prettified JSON to file
-  std::ofstream outFile("galaxy.json");
-  outFile << std::setw(2) << data << std::endl;
+  return saveSnapshotColumns(store, filename, galaxy.galaxySeed, galaxy.SECTOR_SIZE_LY, [&](auto &addColumn) {
+    addColumn("systemStarOffset", SNAPSHOT_INDEX, 1, store.systemStarOffset);
+    addColumn("starPlanetOffset", SNAPSHOT_INDEX, 1, store.starPlanetOffset);
+    addColumn("indexSystemSeed", SNAPSHOT_INDEX, 1, indexSystemSeed);
+    addColumn("indexSystemRow", SNAPSHOT_INDEX, 1, indexSystemRow);
+    addColumn("indexSectorKey", SNAPSHOT_INDEX, 1, indexSectorKey);
+    addColumn("indexSectorFirst", SNAPSHOT_INDEX, 1, indexSectorFirst);
+    addColumn("indexSectorCount", SNAPSHOT_INDEX, 1, indexSectorCount);
+  });
 }
 
 /**
- * @brief Loads and deserializes universe data
- * TODO: add filename as param
- * TODO: add other objects
+ * @brief System record of a catalog row, read without
+ * materializing stars and planets.
+ */
+struct CatalogSystemView {
+  // system row in the catalog
+  size_t row = 0;
+  uint64_t seed = 0;
+  uint64_t sector = 0;
+  // position within the sector in [ly]
+  std::vector<double> position = {0.0, 0.0, 0.0};
+  int multiplicity = 0;
+  // star rows [starBegin, starEnd)
+  uint32_t starBegin = 0;
+  uint32_t starEnd = 0;
+};
+
+/**
+ * @brief Read-only galaxy catalog written by bakeCatalog.
+ * The file is memory mapped and only its header and column
+ * directory are read on open, so opening takes constant time
+ * for any catalog size; pages are loaded on access and shared
+ * through the page cache by all processes mapping the file.
+ * Column sizes are validated on open, the index and offset
+ * values of the rows used by each lookup.
+ * Systems are found by seed (binary search over the sorted
+ * seed index) or by sector key.
+ * Without POSIX mmap the file is read into memory instead.
  */
-void loadGalaxy(ProcUGalaxy &galaxy) {
-  json data;
+class ProcUCatalog {
 
-  // read a JSON file
-  std::ifstream inFile("galaxy.json");
-  inFile >> data;
+public:
+  // row returned when a seed or key is not in the catalog
+  static const size_t npos = (size_t)-1;
 
-  // deserialize from json to object
-  galaxy.galaxySeed = data["galaxy"]["seed"];
+  ProcUCatalog() {}
+  ~ProcUCatalog() { close(); }
+  ProcUCatalog(const ProcUCatalog&) = delete;
+  ProcUCatalog& operator=(const ProcUCatalog&) = delete;
 
-}
+  /**
+   * @brief Maps a catalog file.
+   * @return false if the file is no catalog
+   */
+  bool open(const std::string &filename) {
+    close();
+#ifdef PROCU_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd<0) { return false; }
+    struct stat status;
+    if (fstat(fd, &status)==0 && status.st_size>0) {
+      void *mapped = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+      if (mapped!=MAP_FAILED) {
+        data = (const char*)mapped;
+        dataSize = (size_t)status.st_size;
+      }
+    }
+    ::close(fd);
+#else
+    std::ifstream in(filename, std::ios::binary);
+    buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    dataSize = buffer.size();
+#endif
+    if (!data || !readDirectory()) {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  void close() {
+#ifdef PROCU_MMAP
+    if (data) { munmap((void*)data, dataSize); }
+#endif
+    std::vector<char>().swap(buffer);
+    data = nullptr;
+    dataSize = 0;
+    header = nullptr;
+    columns.clear();
+  }
+
+  bool isOpen() const { return data!=nullptr; }
+  const SnapshotHeader& getHeader() const { return *header; }
+  // object counts, 0 if not open
+  size_t systemCount() const { return header ? header->count[SNAPSHOT_SYSTEM] : 0; }
+  size_t starCount() const { return header ? header->count[SNAPSHOT_STAR] : 0; }
+  size_t planetCount() const { return header ? header->count[SNAPSHOT_PLANET] : 0; }
+
+  /**
+   * @brief Mapped values of a column (see visitSnapshotColumns).
+   * @param count - set to the number of values if given
+   * @return nullptr if the column is missing or has another type
+   */
+  template <class T>
+  const T* column(const std::string &name, size_t *count=nullptr) const {
+    auto entry = columns.find(name);
+    if (entry==columns.end() || entry->second->type!=snapshotType<T>()) {
+      return nullptr;
+    }
+    if (count) { *count = entry->second->bytes / sizeof(T); }
+    return (const T*)(data + entry->second->offset);
+  }
+
+  /**
+   * @brief Row of a system seed, npos if not found.
+   * Legacy seeds may be shared by several systems,
+   * the first row is returned then.
+   */
+  size_t findSystem(const uint64_t seed) const {
+    const uint64_t *begin = indexSystemSeed;
+    const uint64_t *end = indexSystemSeed + systemCount();
+    const uint64_t *found = std::lower_bound(begin, end, seed);
+    if (found==end || *found!=seed || indexSystemRow[found - begin]>=systemCount()) {
+      return npos;
+    }
+    return indexSystemRow[found - begin];
+  }
+
+  /**
+   * @brief System rows [first, first+count) of a sector
+   * key (see sectorKey), count 0 if not found.
+   */
+  std::pair<size_t, size_t> findSector(const uint64_t key) const {
+    const uint64_t *begin = indexSectorKey;
+    const uint64_t *end = indexSectorKey + sectorCount;
+    const uint64_t *found = std::lower_bound(begin, end, key);
+    if (found==end || *found!=key) { return {0, 0}; }
+    size_t first = indexSectorFirst[found - begin];
+    size_t count = indexSectorCount[found - begin];
+    if (first + count > systemCount()) { return {0, 0}; }
+    return {first, count};
+  }
+
+  /**
+   * @brief System record of a row, without stars and planets.
+   * @return an empty view with row npos if row is not
+   *   below systemCount() or its star offsets are invalid
+   */
+  CatalogSystemView getSystemView(const size_t row) const {
+    CatalogSystemView view;
+    if (row>=systemCount() || !validOffsets(systemStarOffset, row, row+1, starCount())) {
+      view.row = npos;
+      return view;
+    }
+    view.row = row;
+    view.seed = systemSeed[row];
+    view.sector = systemSector[row];
+    view.position = {systemX[row] * header->positionScale,
+      systemY[row] * header->positionScale, systemZ[row] * header->positionScale};
+    view.multiplicity = systemMultiplicity[row];
+    view.starBegin = systemStarOffset[row];
+    view.starEnd = systemStarOffset[row+1];
+    return view;
+  }
+
+  /**
+   * @brief Copies the systems of rows [begin, end) with
+   * their stars and planets into a store.
+   * The rows are clamped to [0, systemCount()).
+   * @return an empty store if the offsets of the rows
+   *   are invalid
+   */
+  UniverseStore getSystems(size_t begin, size_t end) const {
+    if (!isOpen()) { return UniverseStore(); }
+    end = min(end, systemCount());
+    begin = min(begin, end);
+    if (!validOffsets(systemStarOffset, begin, end, starCount())
+      || !validOffsets(starPlanetOffset, systemStarOffset[begin], systemStarOffset[end], planetCount())) {
+      return UniverseStore();
+    }
+    size_t range[3][2] = {
+      {begin, end},
+      {systemStarOffset[begin], systemStarOffset[end]},
+      {starPlanetOffset[systemStarOffset[begin]], starPlanetOffset[systemStarOffset[end]]}
+    };
+    UniverseStore store;
+    std::vector<uint32_t> x, y, z;
+    visitSnapshotColumns(store, x, y, z, [&](const char *name, int level, int width, auto &values) {
+      using T = typename std::decay_t<decltype(values)>::value_type;
+      const T *mapped = column<T>(name);
+      if (mapped) {
+        values.assign(mapped + range[level][0]*width, mapped + range[level][1]*width);
+      } else {
+        values.assign((range[level][1]-range[level][0])*width, T());
+      }
+    });
+    // parent indices relative to the copied rows, taken
+    // from the offset columns validated above
+    for (size_t system=begin; system<end; ++system) {
+      for (uint32_t star=systemStarOffset[system]; star<systemStarOffset[system+1]; ++star) {
+        store.starSystem[star - range[SNAPSHOT_STAR][0]] = (uint32_t)(system - begin);
+        for (uint32_t planet=starPlanetOffset[star]; planet<starPlanetOffset[star+1]; ++planet) {
+          store.planetStar[planet - range[SNAPSHOT_PLANET][0]] = (uint32_t)(star - range[SNAPSHOT_STAR][0]);
+        }
+      }
+    }
+    restoreSnapshotStore(store, x, y, z, header->positionScale);
+    return store;
+  }
+
+  /**
+   * @brief Materializes the system of a row with its
+   * stars and planets.
+   * @return a default system if row is not below systemCount()
+   *   or its offsets are invalid
+   */
+  UniverseSystem getSystem(const size_t row) const {
+    UniverseStore store = getSystems(row, row+1);
+    if (store.systemCount()==0) { return UniverseSystem(); }
+    return store.getSystem(0);
+  }
+
+  /**
+   * @brief Materializes the system of a seed.
+   * @return false if the seed is not in the catalog
+   */
+  bool findSystem(const uint64_t seed, UniverseSystem &system) const {
+    size_t row = findSystem(seed);
+    if (row==npos) { return false; }
+    system = getSystem(row);
+    return true;
+  }
+
+private:
+  const char *data = nullptr;
+  size_t dataSize = 0;
+  // file content without mmap
+  std::vector<char> buffer;
+  const SnapshotHeader *header = nullptr;
+  std::unordered_map<std::string, const SnapshotColumn*> columns;
+
+  // columns used for lookups
+  const uint64_t *systemSeed = nullptr;
+  const uint64_t *systemSector = nullptr;
+  const uint32_t *systemX = nullptr;
+  const uint32_t *systemY = nullptr;
+  const uint32_t *systemZ = nullptr;
+  const uint8_t *systemMultiplicity = nullptr;
+  const uint32_t *systemStarOffset = nullptr;
+  const uint32_t *starPlanetOffset = nullptr;
+  const uint64_t *indexSystemSeed = nullptr;
+  const uint32_t *indexSystemRow = nullptr;
+  const uint64_t *indexSectorKey = nullptr;
+  const uint32_t *indexSectorFirst = nullptr;
+  const uint32_t *indexSectorCount = nullptr;
+  size_t sectorCount = 0;
+
+  // validates the header, directory and column sizes,
+  // and resolves the lookup columns
+  bool readDirectory() {
+    if (dataSize<sizeof(SnapshotHeader)) { return false; }
+    header = (const SnapshotHeader*)data;
+    if (std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic))!=0
+      || header->version>SNAPSHOT_VERSION
+      || header->columnCount>(dataSize-sizeof(SnapshotHeader)) / sizeof(SnapshotColumn)) {
+      return false;
+    }
+    const SnapshotColumn *directory = (const SnapshotColumn*)(data + sizeof(SnapshotHeader));
+    for (uint32_t c=0; c<header->columnCount; ++c) {
+      const SnapshotColumn &entry = directory[c];
+      if (entry.offset>dataSize || entry.bytes>dataSize-entry.offset) { return false; }
+      columns[std::string(entry.name, strnlen(entry.name, sizeof(entry.name)))] = &entry;
+    }
+
+    // object columns: aligned, with count*width values of their level
+    bool valid = true;
+    UniverseStore store;
+    std::vector<uint32_t> x, y, z;
+    visitSnapshotColumns(store, x, y, z, [&](const char *name, int level, int width, auto &values) {
+      using T = typename std::decay_t<decltype(values)>::value_type;
+      auto entry = columns.find(name);
+      if (entry!=columns.end()) {
+        valid &= validColumn<T>(*entry->second, header->count[level], width);
+      }
+    });
+    systemSeed = column<uint64_t>("systemSeed");
+    systemSector = column<uint64_t>("systemSector");
+    systemX = column<uint32_t>("systemX");
+    systemY = column<uint32_t>("systemY");
+    systemZ = column<uint32_t>("systemZ");
+    systemMultiplicity = column<uint8_t>("systemMultiplicity");
+    if (!valid || !systemSeed || !systemSector || !systemX || !systemY || !systemZ
+      || !systemMultiplicity) {
+      return false;
+    }
+
+    // offset and index columns
+    systemStarOffset = indexColumn<uint32_t>("systemStarOffset", systemCount()+1);
+    starPlanetOffset = indexColumn<uint32_t>("starPlanetOffset", starCount()+1);
+    indexSystemSeed = indexColumn<uint64_t>("indexSystemSeed", systemCount());
+    indexSystemRow = indexColumn<uint32_t>("indexSystemRow", systemCount());
+    auto sectors = columns.find("indexSectorKey");
+    sectorCount = sectors==columns.end() ? 0 : sectors->second->bytes / sizeof(uint64_t);
+    indexSectorKey = indexColumn<uint64_t>("indexSectorKey", sectorCount);
+    indexSectorFirst = indexColumn<uint32_t>("indexSectorFirst", sectorCount);
+    indexSectorCount = indexColumn<uint32_t>("indexSectorCount", sectorCount);
+    if (!systemStarOffset || !starPlanetOffset || !indexSystemSeed || !indexSystemRow
+      || !indexSectorKey || !indexSectorFirst || !indexSectorCount) {
+      return false;
+    }
+    return true;
+  }
+
+  // checks the type, alignment and size of a column block
+  template <class T>
+  bool validColumn(const SnapshotColumn &entry, const uint64_t count, const int width) const {
+    const uint64_t rowBytes = sizeof(T) * (uint64_t)width;
+    return entry.type==snapshotType<T>() && entry.offset%alignof(T)==0
+      && entry.bytes%rowBytes==0 && entry.bytes/rowBytes==count;
+  }
+
+  // mapped index column of count values, nullptr if invalid
+  template <class T>
+  const T* indexColumn(const std::string &name, const uint64_t count) const {
+    auto entry = columns.find(name);
+    if (entry==columns.end() || !validColumn<T>(*entry->second, count, 1)) {
+      return nullptr;
+    }
+    return column<T>(name);
+  }
+
+  // offsets [begin, end]: non-decreasing, up to total
+  static bool validOffsets(const uint32_t *offsets, const size_t begin, const size_t end, const size_t total) {
+    for (size_t i=begin; i<=end; ++i) {
+      if (offsets[i]>total || (i>begin && offsets[i]<offsets[i-1])) { return false; }
+    }
+    return true;
+  }
+
+}; // end class ProcUCatalog
 
 
 } // end namespace